@@ -22,11 +22,13 @@ SOURCES += \
         handler.cpp \
         logger.cpp \
         main.cpp \
+        messagebuffer.cpp \
         vpnconnection.cpp
 
 HEADERS += \
         handler.h \
         logger.h \
+        messagebuffer.h \
         vpnconnection.h
 
 linux:!android {
@@ -8,6 +8,12 @@
 namespace Constants {
 constexpr uint32_t MAX_MSG_SIZE = 1024 * 1024;
 
+// How much data we try to read at once from STDIN and from the VPN client.
+constexpr uint32_t READ_CHUNK_SIZE = 64 * 1024;
+
+// Bigger messages are relayed without checking if they are a "bridge_ping".
+constexpr uint32_t BRIDGE_PING_MAX_SIZE = 64;
+
 constexpr uint32_t VPN_CLIENT_PORT = 8754;
 constexpr const char* VPN_CLIENT_HOST = "127.0.0.1";
 }  // namespace Constants
@@ -6,10 +6,12 @@
 #include "constants.h"
 #include "logger.h"
 
+#include <cstring>
 #include <iostream>
 
 #ifndef MVPN_WINDOWS
-#  include <sys/select.h>
+#  include <poll.h>
+#  include <unistd.h>
 #else
 #  include <fcntl.h>
 #  include <io.h>
@@ -88,18 +90,21 @@ int Handler::run() {
         (m_vpnConnection.connected() &&
          WaitForSingleObjectEx(handles[1], 0, FALSE) == WAIT_OBJECT_0);
 #else  // POSIX
-    fd_set rfds;
-    int nfds = 0;  // the STDIN
+    struct pollfd fds[2];
+    nfds_t nfds = 1;
 
-    FD_ZERO(&rfds);
-    FD_SET(0, &rfds);
+    fds[0].fd = STDIN_FILENO;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
 
     if (m_vpnConnection.connected()) {
-      FD_SET(m_vpnConnection.socket(), &rfds);
-      nfds = m_vpnConnection.socket();
+      fds[1].fd = m_vpnConnection.socket();
+      fds[1].events = POLLIN;
+      fds[1].revents = 0;
+      ++nfds;
     }
 
-    int rv = select(nfds + 1, &rfds, NULL, NULL, NULL);
+    int rv = poll(fds, nfds, -1);
     if (rv == -1) {
       return 1;
     }
@@ -108,70 +113,83 @@ int Handler::run() {
       continue;
     }
 
-    readStdin = FD_ISSET(0, &rfds);
-    readVpnConnection = m_vpnConnection.connected() &&
-                        FD_ISSET(m_vpnConnection.socket(), &rfds);
+    // Errors and hang-ups are reported by the following read.
+    readStdin = fds[0].revents != 0;
+    readVpnConnection = nfds > 1 && fds[1].revents != 0;
 #endif
 
-    // Something to read from STDIN
+    // Something to read from STDIN. We process all the complete messages.
     if (readStdin) {
       Logger::log("STDIN message received");
 
-      json message;
-      if (!readMessage(message)) {
+      if (!readStdinData()) {
         return 1;
       }
 
-      // This is mainly for testing.
-      if (message == "bridge_ping") {
-        if (!writeMessage("bridge_pong")) {
-          return 1;
+      const char* body;
+      uint32_t length;
+      while (true) {
+        MessageBuffer::Result result = m_stdinBuffer.readMessage(body, length);
+        if (result == MessageBuffer::Incomplete) {
+          break;
         }
 
-        continue;
-      }
-
-      // Maybe we are not connected yet. We need to be connected to send the
-      // message to the VPN client.
-      if (!maybeConnect()) {
-        Logger::log("VPN Client not connected");
-
-        if (!writeVpnNotConnected()) {
+        if (result == MessageBuffer::Invalid) {
+          Logger::log("Failed to read from STDIN");
           return 1;
         }
 
-        continue;
-      }
-
-      // The VPN can be terminated at any time. Let's treat it as a non-fatal
-      // error.
-      if (!m_vpnConnection.writeMessage(message)) {
-        assert(!m_vpnConnection.connected());
-        if (!writeVpnNotConnected()) {
+        if (!processMessage(body, length)) {
           return 1;
         }
-
-        continue;
       }
     }
 
-    // Something to read from the VPN client
-    if (m_vpnConnection.connected() && readVpnConnection) {
-      json message;
-      if (!m_vpnConnection.readMessage(message)) {
-        assert(!m_vpnConnection.connected());
-        continue;
+    // Something to read from the VPN client. All the messages received are
+    // forwarded before flushing STDOUT.
+    if (m_vpnConnection.connected() && readVpnConnection &&
+        m_vpnConnection.readData()) {
+      const char* body;
+      uint32_t length;
+      while (m_vpnConnection.readMessage(body, length)) {
+        if (!writeMessage(body, length)) {
+          return 1;
+        }
       }
+    }
 
-      if (!writeMessage(message)) {
-        return 1;
-      }
+    if (!flushMessages()) {
+      return 1;
     }
   }
 
   return 0;
 }
 
+// Returns false if the message cannot be sent back to the browser.
+bool Handler::processMessage(const char* body, uint32_t length) {
+  // This is mainly for testing.
+  if (isBridgePing(body, length)) {
+    return writeMessage("bridge_pong");
+  }
+
+  // Maybe we are not connected yet. We need to be connected to send the
+  // message to the VPN client.
+  if (!maybeConnect()) {
+    Logger::log("VPN Client not connected");
+    return writeVpnNotConnected();
+  }
+
+  // The VPN can be terminated at any time. Let's treat it as a non-fatal
+  // error.
+  if (!m_vpnConnection.writeMessage(body, length)) {
+    assert(!m_vpnConnection.connected());
+    return writeVpnNotConnected();
+  }
+
+  return true;
+}
+
 bool Handler::maybeConnect() {
   if (m_vpnConnection.connected()) {
     return true;
@@ -180,47 +198,69 @@ bool Handler::maybeConnect() {
   return m_vpnConnection.connect();
 }
 
-// Retrieve a message from the STDIN.
+// The messages are relayed without parsing them. Only the small ones can be a
+// ping.
 // static
-bool Handler::readMessage(json& output) {
-  char rawLength[sizeof(uint32_t)];
-  if (fread(rawLength, sizeof(char), sizeof(uint32_t), stdin) !=
-      sizeof(uint32_t)) {
+bool Handler::isBridgePing(const char* body, uint32_t length) {
+  if (length > Constants::BRIDGE_PING_MAX_SIZE) {
+    return false;
+  }
+
+  json message = json::parse(body, body + length, nullptr, false);
+  return message == "bridge_ping";
+}
+
+// Retrieve data from the STDIN into the STDIN buffer.
+bool Handler::readStdinData() {
+#ifdef MVPN_WINDOWS
+  // STDIN is not buffered: let's read one message at a time.
+  uint32_t length;
+  if (fread(&length, sizeof(uint32_t), 1, stdin) != 1) {
     Logger::log("Failed to read from STDIN");
     return false;
   }
 
-  uint32_t length = *reinterpret_cast<uint32_t*>(rawLength);
   if (!length || length > Constants::MAX_MSG_SIZE) {
     Logger::log("Failed to read from STDIN");
     return false;
   }
 
-  char* message = (char*)malloc(length);
-  if (!message) {
-    Logger::log("Failed to allocate the message buffer");
+  char* buffer = m_stdinBuffer.reserve(sizeof(uint32_t) + length);
+  memcpy(buffer, &length, sizeof(uint32_t));
+
+  if (fread(buffer + sizeof(uint32_t), sizeof(char), length, stdin) !=
+      length) {
+    Logger::log("Failed to read from STDIN");
     return false;
   }
 
-  if (fread(message, sizeof(char), length, stdin) != length) {
+  m_stdinBuffer.commit(sizeof(uint32_t) + length);
+#else
+  // We read from the file descriptor: a buffered FILE could keep messages
+  // that poll() would not report.
+  char* buffer = m_stdinBuffer.reserve(Constants::READ_CHUNK_SIZE);
+  ssize_t rv = read(STDIN_FILENO, buffer, Constants::READ_CHUNK_SIZE);
+  if (rv <= 0) {
     Logger::log("Failed to read from STDIN");
-    free(message);
     return false;
   }
 
-  string m(message, message + length);
-  output = json::parse(m);
+  m_stdinBuffer.commit(rv);
+#endif
 
-  free(message);
   return true;
 }
 
-// Serialize a message to STDOUT
+// Serialize a message to the STDOUT buffer
 // static
 bool Handler::writeMessage(const json& body) {
   string message = body.dump();
+  return writeMessage(message.c_str(), (uint32_t)message.length());
+}
 
-  uint32_t length = (uint32_t)message.length();
+// Write a serialized message to the STDOUT buffer
+// static
+bool Handler::writeMessage(const char* body, uint32_t length) {
   char* rawLength = reinterpret_cast<char*>(&length);
 
   if (fwrite(rawLength, sizeof(char), sizeof(uint32_t), stdout) !=
@@ -229,12 +269,21 @@ bool Handler::writeMessage(const json& body) {
     return false;
   }
 
-  if (fwrite(message.c_str(), sizeof(char), length, stdout) != length) {
+  if (fwrite(body, sizeof(char), length, stdout) != length) {
     Logger::log("Failed to write to STDOUT");
     return false;
   }
 
-  fflush(stdout);
+  return true;
+}
+
+// static
+bool Handler::flushMessages() {
+  if (fflush(stdout) != 0) {
+    Logger::log("Failed to flush STDOUT");
+    return false;
+  }
+
   return true;
 }
 
@@ -6,6 +6,7 @@
 #define HANDLER_H
 
 #include "json.hpp"
+#include "messagebuffer.h"
 #include "vpnconnection.h"
 
 class Handler final {
@@ -13,15 +14,24 @@ class Handler final {
   int run();
 
  private:
-  static bool readMessage(nlohmann::json& output);
+  bool readStdinData();
+  bool processMessage(const char* body, uint32_t length);
 
+  static bool isBridgePing(const char* body, uint32_t length);
+
+  // Messages are written to the STDOUT buffer, which is flushed once per
+  // iteration of the loop.
   static bool writeMessage(const nlohmann::json& body);
+  static bool writeMessage(const char* body, uint32_t length);
   static bool writeVpnNotConnected();
+  static bool flushMessages();
 
   bool maybeConnect();
 
  private:
   VPNConnection m_vpnConnection;
+
+  MessageBuffer m_stdinBuffer;
 };
 
 #endif  // HANDLER_H
@@ -0,0 +1,57 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "messagebuffer.h"
+#include "constants.h"
+
+#include <cassert>
+#include <cstring>
+
+char* MessageBuffer::reserve(size_t size) {
+  if (m_begin == m_end) {
+    m_begin = m_end = 0;
+  }
+
+  if (m_data.size() - m_end < size) {
+    // Let's move the pending data at the beginning of the buffer before
+    // growing it.
+    if (m_begin > 0) {
+      memmove(m_data.data(), m_data.data() + m_begin, m_end - m_begin);
+      m_end -= m_begin;
+      m_begin = 0;
+    }
+
+    if (m_data.size() - m_end < size) {
+      m_data.resize(m_end + size);
+    }
+  }
+
+  return m_data.data() + m_end;
+}
+
+void MessageBuffer::commit(size_t size) {
+  assert(m_end + size <= m_data.size());
+  m_end += size;
+}
+
+MessageBuffer::Result MessageBuffer::readMessage(const char*& body,
+                                                uint32_t& length) {
+  size_t available = m_end - m_begin;
+  if (available < sizeof(uint32_t)) {
+    return Incomplete;
+  }
+
+  memcpy(&length, m_data.data() + m_begin, sizeof(uint32_t));
+  if (!length || length > Constants::MAX_MSG_SIZE) {
+    return Invalid;
+  }
+
+  if (available - sizeof(uint32_t) < length) {
+    return Incomplete;
+  }
+
+  body = m_data.data() + m_begin + sizeof(uint32_t);
+  m_begin += sizeof(uint32_t) + length;
+  return Completed;
+}
@@ -0,0 +1,45 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef MESSAGEBUFFER_H
+#define MESSAGEBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A reusable buffer for the messages exchanged with the browser and with the
+// VPN client: a 32-bit length in native byte order followed by a JSON body.
+// The data is appended as it arrives and the messages are read in place: the
+// bridge only checks the length and relays the body as it is.
+class MessageBuffer final {
+ public:
+  enum Result {
+    // No complete message in the buffer.
+    Incomplete,
+    // A message has been read.
+    Completed,
+    // The length of the next message is not valid.
+    Invalid,
+  };
+
+  // Returns a writable area of at least `size` bytes after the buffered data.
+  char* reserve(size_t size);
+
+  // Appends `size` bytes written in the area returned by reserve().
+  void commit(size_t size);
+
+  // The body points to the buffer: it is valid until the next reserve().
+  Result readMessage(const char*& body, uint32_t& length);
+
+  // Drops the buffered data, keeping the allocated memory.
+  void clear() { m_begin = m_end = 0; }
+
+ private:
+  std::vector<char> m_data;
+  size_t m_begin = 0;
+  size_t m_end = 0;
+};
+
+#endif  // MESSAGEBUFFER_H
@@ -6,6 +6,8 @@
 #include "constants.h"
 #include "logger.h"
 
+#include <cstring>
+
 #ifndef MVPN_WINDOWS
 #  include <arpa/inet.h>
 #  include <assert.h>
@@ -15,7 +17,6 @@
 #  include <unistd.h>
 #endif
 
-using namespace nlohmann;
 using namespace std;
 
 #ifdef MVPN_WINDOWS
@@ -70,15 +71,14 @@ bool VPNConnection::connect() {
   return true;
 }
 
-bool VPNConnection::writeMessage(const json& body) {
+bool VPNConnection::writeMessage(const char* body, uint32_t length) {
   assert(connected());
 
-  string message = body.dump();
-
-  uint32_t length = (uint32_t)message.length();
-  char* rawLength = reinterpret_cast<char*>(&length);
+  // Length and body are sent together. The output buffer is reused.
+  m_output.assign(reinterpret_cast<const char*>(&length), sizeof(uint32_t));
+  m_output.append(body, length);
 
-  if (!write(rawLength, sizeof(uint32_t)) || !write(message.c_str(), length)) {
+  if (!write(m_output.c_str(), (uint32_t)m_output.length())) {
     Logger::log("Failed to write to the VPN Client");
     closeAndReset();
     return false;
@@ -87,42 +87,36 @@ bool VPNConnection::writeMessage(const json& body) {
   return true;
 }
 
-bool VPNConnection::readMessage(nlohmann::json& output) {
+bool VPNConnection::readData() {
   assert(connected());
 
-  char rawLength[sizeof(uint32_t)];
-  if (!read(rawLength, sizeof(uint32_t))) {
+  char* buffer = m_input.reserve(Constants::READ_CHUNK_SIZE);
+  int rv = recv(m_socket, buffer, Constants::READ_CHUNK_SIZE, 0);
+  if (rv <= 0) {
     Logger::log("Failed to read from the VPN Client");
     closeAndReset();
     return false;
   }
 
-  uint32_t length = *reinterpret_cast<uint32_t*>(rawLength);
-  if (!length || length > Constants::MAX_MSG_SIZE) {
-    Logger::log("Invalid package size from the VPN Client");
-    closeAndReset();
-    return false;
-  }
+  m_input.commit(rv);
+  return true;
+}
 
-  char* message = (char*)malloc(length);
-  if (!message) {
-    Logger::log("Failed to allocate the message buffer");
-    closeAndReset();
-    return false;
-  }
+bool VPNConnection::readMessage(const char*& body, uint32_t& length) {
+  assert(connected());
 
-  if (!read(message, length)) {
-    Logger::log("Failed to read from the VPN Client");
-    closeAndReset();
-    free(message);
-    return false;
-  }
+  switch (m_input.readMessage(body, length)) {
+    case MessageBuffer::Completed:
+      return true;
 
-  string m(message, message + length);
-  free(message);
+    case MessageBuffer::Invalid:
+      Logger::log("Invalid package size from the VPN Client");
+      closeAndReset();
+      return false;
 
-  output = json::parse(m);
-  return true;
+    default:
+      return false;
+  }
 }
 
 void VPNConnection::closeAndReset() {
@@ -133,6 +127,7 @@ void VPNConnection::closeAndReset() {
   close(m_socket);
 #endif
   m_socket = VPN_INVALID_SOCKET;
+  m_input.clear();
 }
 
 bool VPNConnection::write(const char* buffer, uint32_t length) {
@@ -151,19 +146,3 @@ bool VPNConnection::write(const char* buffer, uint32_t length) {
 
   return true;
 }
-
-bool VPNConnection::read(char* buffer, uint32_t length) {
-  // The message can be received in chuncks. Let's do consecutive recv() calls
-  // until we have the full message.
-  uint32_t n = 0;
-  while (n < length) {
-    int rv = recv(m_socket, buffer + n, length - n, 0);
-    if (rv <= 0) {
-      return false;
-    }
-
-    n += rv;
-  }
-
-  return true;
-}
@@ -5,7 +5,9 @@
 #ifndef VPNCONNECTION_H
 #define VPNCONNECTION_H
 
-#include "json.hpp"
+#include "messagebuffer.h"
+
+#include <string>
 
 #ifdef MVPN_WINDOWS
 #  include <winsock2.h>
@@ -36,12 +38,17 @@ class VPNConnection final {
 
   bool connect();
 
-  bool readMessage(nlohmann::json& output);
-  bool writeMessage(const nlohmann::json& body);
+  // Receives the available data. Call it when the socket is readable.
+  bool readData();
+
+  // Returns false if no complete message has been received. The body is
+  // valid until the next readData().
+  bool readMessage(const char*& body, uint32_t& length);
+
+  bool writeMessage(const char* body, uint32_t length);
 
  private:
   bool write(const char* buffer, uint32_t length);
-  bool read(char* buffer, uint32_t length);
 
   void closeAndReset();
 
@@ -53,6 +60,9 @@ class VPNConnection final {
 #else
   int m_socket = -1;
 #endif
+
+  MessageBuffer m_input;
+  std::string m_output;
 };
 
 #endif  // VPNCONNECTION_H
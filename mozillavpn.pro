@@ -18,4 +18,5 @@ SUBDIRS += tests/unit
 webextension {
     SUBDIRS += extension/app
     SUBDIRS += tests/nativemessaging
+    SUBDIRS += tests/nativemessaging/benchmark
 }
@@ -497,6 +497,8 @@ class XCodeprojPatcher
       'extension/app/logger.cpp',
       'extension/app/logger.h',
       'extension/app/main.cpp',
+      'extension/app/messagebuffer.cpp',
+      'extension/app/messagebuffer.h',
       'extension/app/vpnconnection.cpp',
       'extension/app/vpnconnection.h',
     ].each { |filename|
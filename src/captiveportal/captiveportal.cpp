@@ -6,6 +6,7 @@
 #include "leakdetector.h"
 #include "logger.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -71,6 +72,8 @@ bool CaptivePortal::fromJson(const QByteArray& data) {
 }
 
 bool CaptivePortal::fromSettings() {
+  StartupTimeline::Span span("CaptivePortal::fromSettings");
+
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
 
@@ -6,8 +6,17 @@
 #include "captiveportalrequest.h"
 #include "leakdetector.h"
 #include "logger.h"
+#include "mozillavpn.h"
 
+// The network needs a moment to settle after a change.
+constexpr uint32_t CAPTIVE_PORTAL_MONITOR_SETTLE_MSEC = 1000;
+
+// The fallback timer grows at each check, up to the max. The max stays short:
+// logging into a portal does not change the link, the routes or the BSSID, so
+// no event wakes us up, and some platforms do not report network changes at
+// all.
 constexpr uint32_t CAPTIVE_PORTAL_MONITOR_MSEC = 10000;
+constexpr uint32_t CAPTIVE_PORTAL_MONITOR_MAX_MSEC = 15000;
 
 namespace {
 Logger logger(LOG_NETWORKING, "CaptivePortalMonitor");
@@ -16,6 +25,7 @@ Logger logger(LOG_NETWORKING, "CaptivePortalMonitor");
 CaptivePortalMonitor::CaptivePortalMonitor(QObject* parent) : QObject(parent) {
   MVPN_COUNT_CTOR(CaptivePortalMonitor);
 
+  m_timer.setSingleShot(true);
   connect(&m_timer, &QTimer::timeout, this, &CaptivePortalMonitor::check);
 }
 
@@ -25,28 +35,86 @@ CaptivePortalMonitor::~CaptivePortalMonitor() {
 
 void CaptivePortalMonitor::start() {
   logger.log() << "Captive portal monitor start";
-  m_timer.start(CAPTIVE_PORTAL_MONITOR_MSEC);
+
+  if (!m_active) {
+    m_active = true;
+    connect(MozillaVPN::instance()->networkWatcher(),
+            &NetworkWatcher::networkChanged, this,
+            &CaptivePortalMonitor::networkChanged);
+  }
+
+  m_fallbackMsec = CAPTIVE_PORTAL_MONITOR_MSEC;
+  scheduleCheck(m_fallbackMsec);
 }
 
 void CaptivePortalMonitor::stop() {
   logger.log() << "Captive portal monitor stop";
+
+  if (m_active) {
+    m_active = false;
+    disconnect(MozillaVPN::instance()->networkWatcher(),
+               &NetworkWatcher::networkChanged, this,
+               &CaptivePortalMonitor::networkChanged);
+  }
+
   m_timer.stop();
+  m_checkPending = false;
+}
+
+void CaptivePortalMonitor::networkChanged() {
+  logger.log() << "Network changed";
+
+  // A new network could have no portal, or the portal could have let us in.
+  m_fallbackMsec = CAPTIVE_PORTAL_MONITOR_MSEC;
+  scheduleCheck(CAPTIVE_PORTAL_MONITOR_SETTLE_MSEC);
+}
+
+void CaptivePortalMonitor::scheduleCheck(uint32_t msec) {
+  if (!m_active) {
+    return;
+  }
+
+  // The running check ignores the last network change. Let's check again when
+  // it completes.
+  if (m_request) {
+    m_checkPending = true;
+    return;
+  }
+
+  m_timer.start(msec);
 }
 
 void CaptivePortalMonitor::check() {
   logger.log() << "Checking the internet connectivity";
 
-  CaptivePortalRequest* request = new CaptivePortalRequest(this);
-  connect(request, &CaptivePortalRequest::completed, [this](bool detected) {
-    logger.log() << "Captive portal detection:" << detected;
+  Q_ASSERT(!m_request);
+
+  m_request = new CaptivePortalRequest(this);
+  connect(m_request, &CaptivePortalRequest::completed,
+          [this](CaptivePortalResult detected) {
+            logger.log() << "Captive portal detection:" << detected;
+            m_request = nullptr;
+
+            if (!m_active) {
+              return;
+            }
+
+            if (detected == NoPortal) {
+              // It seems that the captive-portal is gone. We can reactivate
+              // the VPN.
+              emit online();
+            }
 
-    if (detected || !m_timer.isActive()) {
-      return;
-    }
+            if (m_checkPending) {
+              m_checkPending = false;
+              scheduleCheck(CAPTIVE_PORTAL_MONITOR_SETTLE_MSEC);
+              return;
+            }
 
-    // It seems that the captive-portal is gone. We can reactivate the VPN.
-    emit online();
-  });
+            m_fallbackMsec =
+                qMin(m_fallbackMsec * 2, CAPTIVE_PORTAL_MONITOR_MAX_MSEC);
+            scheduleCheck(m_fallbackMsec);
+          });
 
-  request->run();
+  m_request->run();
 }
@@ -8,6 +8,11 @@
 #include <QObject>
 #include <QTimer>
 
+class CaptivePortalRequest;
+
+// Waits for the captive portal to go away. A check runs soon after each
+// network change. Without network changes, the checks run on a fallback timer
+// which slows down at each check.
 class CaptivePortalMonitor final : public QObject {
   Q_OBJECT
 
@@ -22,10 +27,18 @@ class CaptivePortalMonitor final : public QObject {
   void online();
 
  private:
+  void networkChanged();
   void check();
+  void scheduleCheck(uint32_t msec);
 
  private:
   QTimer m_timer;
+
+  bool m_active = false;
+  uint32_t m_fallbackMsec = 0;
+
+  CaptivePortalRequest* m_request = nullptr;
+  bool m_checkPending = false;
 };
 
 #endif  // CAPTIVEPORTALMONITOR_H
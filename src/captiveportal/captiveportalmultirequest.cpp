@@ -8,10 +8,16 @@
 #include "captiveportal.h"
 #include "leakdetector.h"
 #include "logger.h"
+#include "mozillavpn.h"
 #include "networkrequest.h"
 #include "settingsholder.h"
 #include "timersingleshot.h"
 #include "networkmanager.h"
+#include "retrypolicy.h"
+
+constexpr int CAPTIVEPORTAL_MAX_ATTEMPTS = 10;
+constexpr uint32_t CAPTIVEPORTAL_INITIAL_DELAY_MSEC = 500;
+constexpr uint32_t CAPTIVEPORTAL_MAX_DELAY_MSEC = 8000;
 
 namespace {
 Logger logger(LOG_CAPTIVEPORTAL, "CaptivePortalMultiRequest");
@@ -28,6 +34,18 @@ CaptivePortalMultiRequest::~CaptivePortalMultiRequest() {
 
 void CaptivePortalMultiRequest::run() {
   m_completed = false;
+  m_attempts = 0;
+
+  // A portal recently detected on the same network saves a round of probes.
+  CaptivePortalResult cached = Failure;
+  if (CaptivePortalRequest::cachedResult(
+          MozillaVPN::instance()->networkWatcher()->currentNetworkId(),
+          &cached)) {
+    logger.log() << "Using the cached captive portal result:" << cached;
+    TimerSingleShot::create(this, 0, [this, cached]() { onResult(cached); });
+    return;
+  }
+
   // If we can't confirm in 30s that we are not behind
   // a captive-portal, handle this like no portal exists
   TimerSingleShot::create(this, 30 * 1000, [this]() {
@@ -38,8 +56,13 @@ void CaptivePortalMultiRequest::run() {
 }
 
 void CaptivePortalMultiRequest::createRequest() {
-  NetworkManager::instance()->clearCache();
-  CaptivePortalRequest* request = new CaptivePortalRequest(this);
+  ++m_attempts;
+
+  // Each detection starts from fresh connections, without dropping the API
+  // ones.
+  NetworkManager::instance()->discardProbeNetworkAccessManager();
+  CaptivePortalRequest* request = new CaptivePortalRequest(
+      this, MozillaVPN::instance()->networkWatcher()->currentNetworkId());
   connect(request, &CaptivePortalRequest::completed,
           [this](CaptivePortalResult detected) {
             logger.log() << "Captive portal detection:" << detected;
@@ -54,9 +77,18 @@ void CaptivePortalMultiRequest::onResult(CaptivePortalResult portalDetected) {
     return;
   }
   if (portalDetected == CaptivePortalResult::Failure) {
-    logger.log() << "Captive portal detect failed, retry!";
-    TimerSingleShot::create(this, 500, [this]() { createRequest(); });
-    return;
+    RetryPolicy policy(CAPTIVEPORTAL_MAX_ATTEMPTS,
+                       CAPTIVEPORTAL_INITIAL_DELAY_MSEC,
+                       CAPTIVEPORTAL_MAX_DELAY_MSEC);
+    if (policy.canRetry(m_attempts)) {
+      uint32_t delay = policy.delayMsec(m_attempts);
+      logger.log() << "Captive portal detect failed, retry in" << delay << "ms";
+      TimerSingleShot::create(this, delay, [this]() { createRequest(); });
+      return;
+    }
+
+    logger.log() << "Captive portal detect failed too many times";
+    portalDetected = NoPortal;
   }
   m_completed = true;
   deleteLater();
@@ -30,6 +30,7 @@ class CaptivePortalMultiRequest final : public QObject {
 
  private:
   bool m_completed = false;
+  int m_attempts = 0;
 };
 
 #endif  // CAPTIVEPORTALMULTIREQUEST_H
@@ -8,13 +8,25 @@
 #include "logger.h"
 #include "networkrequest.h"
 #include "settingsholder.h"
-#include "timersingleshot.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+
+#include <utility>
+
+// How long a detected portal is remembered for the same network.
+constexpr int64_t CAPTIVEPORTAL_RESULT_TTL_MSEC = 60000;
 
 namespace {
 Logger logger(LOG_CAPTIVEPORTAL, "CaptivePortalRequest");
-}
 
-CaptivePortalRequest::CaptivePortalRequest(QObject* parent) : QObject(parent) {
+// When a portal has been detected, by network.
+QHash<QString, QElapsedTimer> s_portals;
+}  // namespace
+
+CaptivePortalRequest::CaptivePortalRequest(QObject* parent,
+                                           const QString& networkId)
+    : QObject(parent), m_networkId(networkId) {
   MVPN_COUNT_CTOR(CaptivePortalRequest);
 }
 
@@ -22,6 +34,24 @@ CaptivePortalRequest::~CaptivePortalRequest() {
   MVPN_COUNT_DTOR(CaptivePortalRequest);
 }
 
+// static
+bool CaptivePortalRequest::cachedResult(const QString& networkId,
+                                        CaptivePortalResult* result) {
+  Q_ASSERT(result);
+
+  auto i = s_portals.constFind(networkId);
+  if (networkId.isEmpty() || i == s_portals.constEnd() ||
+      i->hasExpired(CAPTIVEPORTAL_RESULT_TTL_MSEC)) {
+    return false;
+  }
+
+  *result = PortalDetected;
+  return true;
+}
+
+// static
+void CaptivePortalRequest::clearCache() { s_portals.clear(); }
+
 void CaptivePortalRequest::run() {
   SettingsHolder* settings = SettingsHolder::instance();
 
@@ -47,8 +77,8 @@ void CaptivePortalRequest::run() {
   }
 
   // We do not care which request succeeds.
-  // Let's make 1 request for any available IP addresses. The first one will
-  // delete all the others.
+  // Let's make 1 request for any available IP addresses. The first conclusive
+  // answer aborts all the others.
 
   for (const QString& address : ipv4Addresses) {
     QUrl url(QString(CAPTIVEPORTAL_URL_IPV4).arg(address));
@@ -67,15 +97,21 @@ void CaptivePortalRequest::createRequest(const QUrl& url) {
   NetworkRequest* request = NetworkRequest::createForCaptivePortalDetection(
       this, url, CAPTIVEPORTAL_HOST);
 
-  connect(request, &NetworkRequest::requestFailed,
-          [this](QNetworkReply::NetworkError error, const QByteArray&) {
+  m_requests.append(request);
+
+  // The lambdas are bound to this object: onResult() disconnects them.
+  connect(request, &NetworkRequest::requestFailed, this,
+          [this, request](QNetworkReply::NetworkError error,
+                          const QByteArray&) {
             logger.log() << "Captive portal request failed:" << error;
-            onResult(Failure);
+            requestFailed(request);
           });
 
-  connect(request, &NetworkRequest::requestCompleted,
+  connect(request, &NetworkRequest::requestCompleted, this,
           [this, request](const QByteArray& data) {
             logger.log() << "Captive portal request completed:" << data;
+            m_requests.removeOne(request);
+
             // Usually, captive-portal pages do a redirect to an internal page.
             if (request->statusCode() != 200) {
               logger.log() << "Captive portal detected. Expected 200, received:"
@@ -95,11 +131,46 @@ void CaptivePortalRequest::createRequest(const QUrl& url) {
           });
 }
 
+void CaptivePortalRequest::requestFailed(NetworkRequest* request) {
+  m_requests.removeOne(request);
+
+  // Another address could still answer.
+  if (!m_requests.isEmpty()) {
+    return;
+  }
+
+  onResult(Failure);
+}
+
 void CaptivePortalRequest::onResult(CaptivePortalResult portalDetected) {
   if (m_completed) {
     return;
   }
   m_completed = true;
+
+  const auto requests = std::exchange(m_requests, {});
+  for (NetworkRequest* request : requests) {
+    request->disconnect(this);
+    request->abort();
+  }
+
+  // Only the portals are remembered: a portal can appear again on the same
+  // network at any time (a session expiring, for instance).
+  if (portalDetected == NoPortal) {
+    s_portals.remove(m_networkId);
+  } else if (portalDetected == PortalDetected && !m_networkId.isEmpty()) {
+    // Let's drop the expired results of the other networks.
+    for (auto i = s_portals.begin(); i != s_portals.end();) {
+      if (i->hasExpired(CAPTIVEPORTAL_RESULT_TTL_MSEC)) {
+        i = s_portals.erase(i);
+      } else {
+        ++i;
+      }
+    }
+
+    s_portals[m_networkId].start();
+  }
+
   deleteLater();
   emit completed(portalDetected);
 }
@@ -7,29 +7,45 @@
 
 #include "captiveportalresult.h"
 
+#include <QList>
 #include <QObject>
 #include <QUrl>
 
+class NetworkRequest;
+
+// Probes all the captive-portal addresses in parallel. The first conclusive
+// answer wins and the other probes are aborted. The result is a failure only
+// when all the probes fail.
 class CaptivePortalRequest final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(CaptivePortalRequest)
 
  public:
-  explicit CaptivePortalRequest(QObject* parent);
+  CaptivePortalRequest(QObject* parent, const QString& networkId);
   ~CaptivePortalRequest();
 
   void run();
 
+  // A detected portal is kept for a short time for each network (see
+  // NetworkWatcher::currentNetworkId()). The absence of a portal is never
+  // cached.
+  static bool cachedResult(const QString& networkId,
+                           CaptivePortalResult* result);
+  static void clearCache();
+
  signals:
   void completed(CaptivePortalResult detected);
 
  private:
   void createRequest(const QUrl& url);
-  void nextStep();
+  void requestFailed(NetworkRequest* request);
   void onResult(CaptivePortalResult portalDetected);
 
  private:
   bool m_completed = false;
+
+  QString m_networkId;
+  QList<NetworkRequest*> m_requests;
 };
 
 #endif  // CAPTIVEPORTALREQUEST_H
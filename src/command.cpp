@@ -12,6 +12,7 @@
 #include "mozillavpn.h"
 #include "settingsholder.h"
 #include "simplenetworkmanager.h"
+#include "startuptimeline.h"
 
 #ifdef MVPN_WINDOWS
 #  include <Windows.h>
@@ -117,6 +118,8 @@ int Command::runGuiApp(std::function<int()>&& a_callback) {
 int Command::runQmlApp(std::function<int()>&& a_callback) {
   std::function<int()> callback = std::move(a_callback);
 
+  StartupTimeline::start();
+
   // Our logging system.
   qInstallMessageHandler(LogHandler::messageQTHandler);
   logger.log() << "MozillaVPN" << APP_VERSION;
@@ -128,13 +131,20 @@ int Command::runQmlApp(std::function<int()>&& a_callback) {
 
   QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 
+  qint64 appStart = StartupTimeline::nowNsec();
   QApplication app(CommandLineParser::argc(), CommandLineParser::argv());
+  StartupTimeline::record("QApplication", appStart);
 
   QCoreApplication::setApplicationName("Mozilla VPN");
   QCoreApplication::setApplicationVersion(APP_VERSION);
 
+  qint64 settingsStart = StartupTimeline::nowNsec();
   SettingsHolder settingsHolder;
+  StartupTimeline::record("SettingsHolder", settingsStart);
+
+  qint64 localizerStart = StartupTimeline::nowNsec();
   Localizer localizer;
+  StartupTimeline::record("Localizer", localizerStart);
 
   QIcon icon(Constants::LOGO_URL);
   app.setWindowIcon(icon);
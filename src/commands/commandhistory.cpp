@@ -0,0 +1,128 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "commandhistory.h"
+#include "commandlineparser.h"
+#include "leakdetector.h"
+#include "throughputhistory.h"
+
+#include <QDateTime>
+#include <QTextStream>
+
+constexpr qint64 HISTORY_DEFAULT_PERIOD_SEC = 24 * 3600;
+
+CommandHistory::CommandHistory(QObject* parent)
+    : Command(parent, "history", "Show the VPN traffic history.") {
+  MVPN_COUNT_CTOR(CommandHistory);
+}
+
+CommandHistory::~CommandHistory() { MVPN_COUNT_DTOR(CommandHistory); }
+
+int CommandHistory::run(QStringList& tokens) {
+  Q_ASSERT(!tokens.isEmpty());
+  return runCommandLineApp([&]() {
+    QString appName = tokens[0];
+
+    CommandLineParser::Option hOption = CommandLineParser::helpOption();
+    CommandLineParser::Option secondsOption("s", "seconds", "Per second.");
+    CommandLineParser::Option minutesOption("m", "minutes", "Per minute.");
+    CommandLineParser::Option hoursOption("H", "hours", "Per hour.");
+
+    QList<CommandLineParser::Option*> options;
+    options.append(&hOption);
+    options.append(&secondsOption);
+    options.append(&minutesOption);
+    options.append(&hoursOption);
+
+    CommandLineParser clp;
+    if (clp.parse(tokens, options, false)) {
+      return 1;
+    }
+
+    if (hOption.m_set || tokens.length() > 1) {
+      QTextStream stream(stdout);
+      stream << "usage: " << appName << " [options] [<period>]" << Qt::endl;
+      stream << Qt::endl;
+      stream << "<period> is a number followed by s, m, h or d. Default: 24h."
+             << Qt::endl;
+      clp.showHelp(this, appName, options, false, false);
+      return hOption.m_set ? 0 : 1;
+    }
+
+    qint64 period = HISTORY_DEFAULT_PERIOD_SEC;
+    if (!tokens.isEmpty()) {
+      period = parsePeriod(tokens[0]);
+      if (period <= 0) {
+        QTextStream stream(stdout);
+        stream << "invalid period: " << tokens[0] << Qt::endl;
+        return 1;
+      }
+    }
+
+    ThroughputHistory history;
+    if (!history.load()) {
+      QTextStream stream(stdout);
+      stream << "No history" << Qt::endl;
+      return 0;
+    }
+
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    qint64 from = now - period;
+
+    ThroughputHistory::Resolution resolution =
+        history.resolutionFor(from, now);
+    if (secondsOption.m_set) {
+      resolution = ThroughputHistory::Seconds;
+    } else if (minutesOption.m_set) {
+      resolution = ThroughputHistory::Minutes;
+    } else if (hoursOption.m_set) {
+      resolution = ThroughputHistory::Hours;
+    }
+
+    quint64 txTotal = 0;
+    quint64 rxTotal = 0;
+
+    QTextStream stream(stdout);
+    for (const ThroughputHistory::Sample& sample :
+         history.query(from, now, resolution)) {
+      stream << QDateTime::fromSecsSinceEpoch(sample.m_time).toString(
+                    Qt::ISODate)
+             << " - tx: " << sample.m_txBytes << " - rx: " << sample.m_rxBytes
+             << Qt::endl;
+      txTotal += sample.m_txBytes;
+      rxTotal += sample.m_rxBytes;
+    }
+
+    stream << "Total - tx: " << txTotal << " - rx: " << rxTotal << Qt::endl;
+    return 0;
+  });
+}
+
+// static
+qint64 CommandHistory::parsePeriod(const QString& period) {
+  if (period.length() < 2) {
+    return -1;
+  }
+
+  bool ok = false;
+  qint64 value = period.left(period.length() - 1).toLongLong(&ok);
+  if (!ok) {
+    return -1;
+  }
+
+  switch (period.at(period.length() - 1).toLatin1()) {
+    case 's':
+      return value;
+    case 'm':
+      return value * 60;
+    case 'h':
+      return value * 3600;
+    case 'd':
+      return value * 86400;
+    default:
+      return -1;
+  }
+}
+
+static Command::RegistrationProxy<CommandHistory> s_commandHistory;
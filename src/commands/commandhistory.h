@@ -0,0 +1,21 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef COMMANDHISTORY_H
+#define COMMANDHISTORY_H
+
+#include "command.h"
+
+class CommandHistory final : public Command {
+ public:
+  explicit CommandHistory(QObject* parent);
+  ~CommandHistory();
+
+  int run(QStringList& tokens) override;
+
+ private:
+  static qint64 parsePeriod(const QString& period);
+};
+
+#endif  // COMMANDHISTORY_H
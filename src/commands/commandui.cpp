@@ -16,6 +16,7 @@
 #include "notificationhandler.h"
 #include "qmlengineholder.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 #include "systemtrayhandler.h"
 
 #include "apppermission.h"
@@ -65,6 +66,11 @@
 #endif
 
 #include <QApplication>
+#include <QJsonDocument>
+#include <QQuickWindow>
+#include <QTextStream>
+
+#include <memory>
 
 #ifdef QT_DEBUG
 #  include "gleantest.h"
@@ -91,11 +97,15 @@ int CommandUI::run(QStringList& tokens) {
                                               "Start minimized.");
     CommandLineParser::Option startAtBootOption(
         "s", "start-at-boot", "Start at boot (if configured).");
+    CommandLineParser::Option traceStartupOption(
+        "t", "trace-startup",
+        "Print the startup timeline in the Chrome trace format at exit.");
 
     QList<CommandLineParser::Option*> options;
     options.append(&hOption);
     options.append(&minimizedOption);
     options.append(&startAtBootOption);
+    options.append(&traceStartupOption);
 
     CommandLineParser clp;
     if (clp.parse(tokens, options, false)) {
@@ -151,7 +161,10 @@ int CommandUI::run(QStringList& tokens) {
     FontLoader::loadFonts();
 
     // Create the QML engine and expose a few internal objects.
+    qint64 engineStart = StartupTimeline::nowNsec();
     QmlEngineHolder engineHolder;
+    StartupTimeline::record("QmlEngineHolder", engineStart);
+
     QQmlApplicationEngine* engine = QmlEngineHolder::instance()->engine();
     vpn.initialize();
 
@@ -266,6 +279,14 @@ int CommandUI::run(QStringList& tokens) {
           return obj;
         });
 
+    qmlRegisterSingletonType<MozillaVPN>(
+        "Mozilla.VPN", 1, 0, "VPNThroughputHistory",
+        [](QQmlEngine*, QJSEngine*) -> QObject* {
+          QObject* obj = MozillaVPN::instance()->throughputHistory();
+          QQmlEngine::setObjectOwnership(obj, QQmlEngine::CppOwnership);
+          return obj;
+        });
+
     qmlRegisterSingletonType<MozillaVPN>(
         "Mozilla.VPN", 1, 0, "VPNLocalizer",
         [](QQmlEngine*, QJSEngine*) -> QObject* {
@@ -361,7 +382,32 @@ int CommandUI::run(QStringList& tokens) {
           }
         },
         Qt::QueuedConnection);
-    engine->load(url);
+    {
+      StartupTimeline::Span span("QQmlApplicationEngine::load");
+      engine->load(url);
+    }
+
+    // The main window is shown at the first frame. Let's measure it for the
+    // inspector.
+    QQuickWindow* window = engine->rootObjects().isEmpty()
+                               ? nullptr
+                               : qobject_cast<QQuickWindow*>(
+                                     engine->rootObjects().first());
+    if (window) {
+      auto connection = std::make_shared<QMetaObject::Connection>();
+      *connection = QObject::connect(
+          window, &QQuickWindow::frameSwapped, qApp,
+          [connection]() {
+            QObject::disconnect(*connection);
+
+            StartupTimeline::mark("First frame");
+
+            qint64 msec = StartupTimeline::elapsedMsec();
+            logger.log() << "First frame after" << msec << "msecs";
+            QmlEngineHolder::instance()->setFirstFrameMsec(msec);
+          },
+          Qt::QueuedConnection);
+    }
 
     SystemTrayHandler* systemTrayHandler =
         SystemTrayHandler::create(&engineHolder);
@@ -436,6 +482,14 @@ int CommandUI::run(QStringList& tokens) {
                      &ServerHandler::close);
 #endif
 
+    if (traceStartupOption.m_set) {
+      QObject::connect(qApp, &QCoreApplication::aboutToQuit, []() {
+        QTextStream stream(stdout);
+        stream << QJsonDocument(StartupTimeline::toChromeTrace()).toJson()
+               << Qt::flush;
+      });
+    }
+
     // Let's go.
     return qApp->exec();
   });
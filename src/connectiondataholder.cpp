@@ -13,6 +13,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QPointF>
 #include <QSplineSeries>
 #include <QValueAxis>
 
@@ -27,6 +28,8 @@ ConnectionDataHolder::ConnectionDataHolder()
       m_ipv6Address(qtTrId("vpn.connectionInfo.loading")) {
   MVPN_COUNT_CTOR(ConnectionDataHolder);
 
+  m_data.resize(Constants::CHARTS_MAX_POINTS);
+
   connect(&m_ipAddressTimer, &QTimer::timeout, [this]() { updateIpAddress(); });
   connect(&m_checkStatusTimer, &QTimer::timeout, [this]() {
     MozillaVPN::instance()->controller()->getStatus(
@@ -80,27 +83,54 @@ void ConnectionDataHolder::add(uint64_t txBytes, uint64_t rxBytes) {
   m_txBytes = tmpTxBytes;
   m_rxBytes = tmpRxBytes;
 
-  m_maxBytes = std::max(m_maxBytes, std::max(txBytes, rxBytes));
-  m_data.append(QPair<uint64_t, uint64_t>(txBytes, rxBytes));
+  if (m_dataCount < Constants::CHARTS_MAX_POINTS) {
+    m_data[(m_dataHead + m_dataCount) % Constants::CHARTS_MAX_POINTS] =
+        QPair<uint64_t, uint64_t>(txBytes, rxBytes);
+    ++m_dataCount;
+  } else {
+    m_data[m_dataHead] = QPair<uint64_t, uint64_t>(txBytes, rxBytes);
+    m_dataHead = (m_dataHead + 1) % Constants::CHARTS_MAX_POINTS;
+  }
+
+  updateSeries();
 
-  while (m_data.length() > Constants::CHARTS_MAX_POINTS) {
-    m_data.removeAt(0);
+  uint64_t maxBytes = std::max(m_maxBytes, std::max(txBytes, rxBytes));
+  if (maxBytes != m_maxBytes) {
+    m_maxBytes = maxBytes;
+    computeAxes();
   }
 
+  emit bytesChanged();
+}
+
+void ConnectionDataHolder::updateSeries() {
+  if (!m_txSeries) {
+    return;
+  }
+
+  // One bulk replace per series: replacing the points one by one repaints
+  // the chart for each of them.
+  QVector<QPointF> txPoints;
+  QVector<QPointF> rxPoints;
+  txPoints.reserve(Constants::CHARTS_MAX_POINTS);
+  rxPoints.reserve(Constants::CHARTS_MAX_POINTS);
+
   int i = 0;
-  for (; i < Constants::CHARTS_MAX_POINTS - m_data.length(); ++i) {
-    m_txSeries->replace(i, i, 0);
-    m_rxSeries->replace(i, i, 0);
+  for (; i < Constants::CHARTS_MAX_POINTS - m_dataCount; ++i) {
+    txPoints.append(QPointF(i, 0));
+    rxPoints.append(QPointF(i, 0));
   }
 
-  for (int j = 0; j < m_data.length(); ++j) {
-    m_txSeries->replace(i, i, m_data.at(j).first);
-    m_rxSeries->replace(i, i, m_data.at(j).second);
+  for (int j = 0; j < m_dataCount; ++j) {
+    const QPair<uint64_t, uint64_t>& pair =
+        m_data.at((m_dataHead + j) % Constants::CHARTS_MAX_POINTS);
+    txPoints.append(QPointF(i, pair.first));
+    rxPoints.append(QPointF(i, pair.second));
     ++i;
   }
 
-  computeAxes();
-  emit bytesChanged();
+  m_txSeries->replace(txPoints);
+  m_rxSeries->replace(rxPoints);
 }
 
 void ConnectionDataHolder::activate(const QVariant& a_txSeries,
@@ -186,22 +216,12 @@ void ConnectionDataHolder::reset() {
   m_txBytes = 0;
   m_rxBytes = 0;
   m_maxBytes = 0;
-  m_data.clear();
+  m_dataHead = 0;
+  m_dataCount = 0;
 
   emit bytesChanged();
 
-  if (m_txSeries) {
-    // In theory, m_txSeries and m_rxSeries should contain
-    // Constants::CHARTS_MAX_POINTS elements, but during the shutdown, strange
-    // things happen.
-    for (int i = 0; i < m_txSeries->count(); ++i) {
-      m_txSeries->replace(i, i, 0);
-    }
-
-    for (int i = 0; i < m_rxSeries->count(); ++i) {
-      m_rxSeries->replace(i, i, 0);
-    }
-  }
+  updateSeries();
 
   updateIpAddress();
 }
@@ -265,11 +285,12 @@ quint64 ConnectionDataHolder::txBytes() const { return bytes(0); }
 quint64 ConnectionDataHolder::rxBytes() const { return bytes(1); }
 
 quint64 ConnectionDataHolder::bytes(bool index) const {
-  if (m_data.isEmpty()) {
+  if (!m_dataCount) {
     return 0;
   }
 
-  const QPair<uint64_t, uint64_t>& pair = m_data.last();
+  const QPair<uint64_t, uint64_t>& pair =
+      m_data.at((m_dataHead + m_dataCount - 1) % Constants::CHARTS_MAX_POINTS);
   return !index ? pair.first : pair.second;
 }
 
@@ -50,6 +50,7 @@ class ConnectionDataHolder final : public QObject {
  private:
   void add(uint64_t txBytes, uint64_t rxBytes);
 
+  void updateSeries();
   void computeAxes();
   void updateIpAddress();
 
@@ -75,7 +76,11 @@ class ConnectionDataHolder final : public QObject {
   QtCharts::QValueAxis* m_axisX = nullptr;
   QtCharts::QValueAxis* m_axisY = nullptr;
 
+  // Ring buffer of the last Constants::CHARTS_MAX_POINTS deltas. m_dataHead is
+  // the index of the oldest one.
   QVector<QPair<uint64_t, uint64_t>> m_data;
+  int m_dataHead = 0;
+  int m_dataCount = 0;
 
   bool m_initialized = false;
   uint64_t m_txBytes = 0;
@@ -111,6 +111,18 @@ void ConnectionHealth::pingSentAndReceived(qint64 msec) {
   }
 }
 
+void ConnectionHealth::networkChanged() {
+  if (m_suspended) {
+    return;
+  }
+
+  // WireGuard follows the new source address as soon as a packet goes through
+  // the tunnel, and starts a new handshake if the session has expired. A ping
+  // now avoids waiting for the next one.
+  logger.log() << "Network changed. Sending a ping";
+  m_pingHelper.sendPingNow();
+}
+
 void ConnectionHealth::noSignalDetected() {
   logger.log() << "No signal detected";
   setStability(NoSignal);
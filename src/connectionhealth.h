@@ -32,6 +32,7 @@ class ConnectionHealth final : public QObject {
  public slots:
   void connectionStateChanged();
   void applicationStateChanged(Qt::ApplicationState state);
+  void networkChanged();
 
  signals:
   void stabilityChanged();
@@ -14,6 +14,7 @@
 #include "rfc1918.h"
 #include "rfc4193.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 #include "tasks/heartbeat/taskheartbeat.h"
 #include "timercontroller.h"
 #include "timersingleshot.h"
@@ -70,6 +71,10 @@ Controller::State Controller::state() const { return m_state; }
 void Controller::initialize() {
   logger.log() << "Initializing the controller";
 
+  if (!m_firstInitializationDone) {
+    m_initializationStartNsec = StartupTimeline::nowNsec();
+  }
+
   if (m_state != StateInitializing) {
     setState(StateInitializing);
   }
@@ -117,6 +122,12 @@ void Controller::implInitialized(bool status, bool a_connected,
 
   Q_ASSERT(m_state == StateInitializing);
 
+  if (!m_firstInitializationDone) {
+    m_firstInitializationDone = true;
+    StartupTimeline::record("Controller::initialize",
+                            m_initializationStartNsec);
+  }
+
   if (!status) {
     MozillaVPN::instance()->errorHandle(ErrorHandler::ControllerError);
     setState(StateOff);
@@ -481,6 +492,20 @@ void Controller::getBackendLogs(
   m_impl->getBackendLogs(std::move(callback));
 }
 
+void Controller::getBackendLogsChunk(
+    const QString& cursor,
+    std::function<void(const QString&, const QString&)>&& a_callback) {
+  std::function<void(const QString&, const QString&)> callback =
+      std::move(a_callback);
+
+  if (!m_impl) {
+    callback(QString(), QString());
+    return;
+  }
+
+  m_impl->getBackendLogsChunk(cursor, std::move(callback));
+}
+
 void Controller::cleanupBackendLogs() {
   if (m_impl) {
     m_impl->cleanupBackendLogs();
@@ -68,6 +68,11 @@ class Controller final : public QObject {
 
   void getBackendLogs(std::function<void(const QString& logs)>&& callback);
 
+  void getBackendLogsChunk(
+      const QString& cursor,
+      std::function<void(const QString& logs, const QString& nextCursor)>&&
+          callback);
+
   void cleanupBackendLogs();
 
   void getStatus(
@@ -164,6 +169,10 @@ class Controller final : public QObject {
 
   ReconnectionStep m_reconnectionStep = NoReconnection;
 
+  // Only the first initialization is part of the startup timeline.
+  bool m_firstInitializationDone = false;
+  qint64 m_initializationStartNsec = -1;
+
   QList<std::function<void(const QString& serverIpv4Gateway,
                            const QString& deviceIpv4Address, uint64_t txBytes,
                            uint64_t rxBytes)>>
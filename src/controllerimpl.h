@@ -65,6 +65,22 @@ class ControllerImpl : public QObject {
   virtual void getBackendLogs(
       std::function<void(const QString& logs)>&& callback) = 0;
 
+  // This method is used to retrieve the logs from the backend service in
+  // chunks. "cursor" is empty for the first chunk. The callback receives the
+  // logs and the cursor of the next chunk, which is empty when there is
+  // nothing else to read. By default, all the logs are sent in one chunk.
+  virtual void getBackendLogsChunk(
+      const QString& cursor,
+      std::function<void(const QString& logs, const QString& nextCursor)>&&
+          a_callback) {
+    Q_UNUSED(cursor);
+    std::function<void(const QString&, const QString&)> callback =
+        std::move(a_callback);
+    getBackendLogs([callback = std::move(callback)](const QString& logs) {
+      callback(logs, QString());
+    });
+  }
+
   // Cleanup the backend logs.
   virtual void cleanupBackendLogs() = 0;
 
@@ -306,6 +306,10 @@ QString Daemon::logs() {
   return output;
 }
 
+QString Daemon::logsChunk(const QString& cursor, QString& nextCursor) {
+  return QString::fromUtf8(LogHandler::readLogChunk(cursor, nextCursor));
+}
+
 void Daemon::cleanLogs() { LogHandler::instance()->cleanupLogs(); }
 
 bool Daemon::switchServer(const InterfaceConfig& config) {
@@ -11,6 +11,7 @@
 #include "wireguardutils.h"
 
 #include <QDateTime>
+#include <QJsonObject>
 
 class Daemon : public QObject {
   Q_OBJECT
@@ -32,9 +33,10 @@ class Daemon : public QObject {
   virtual bool deactivate(bool emitSignals = true);
 
   // Explose a JSON object with the daemon status.
-  virtual QByteArray getStatus() = 0;
+  virtual QJsonObject getStatus() = 0;
 
   QString logs();
+  QString logsChunk(const QString& cursor, QString& nextCursor);
   void cleanLogs();
 
  signals:
@@ -48,39 +48,15 @@ void DaemonLocalServerConnection::readData() {
   logger.log() << "Read Data";
 
   Q_ASSERT(m_socket);
-  QByteArray input = m_socket->readAll();
-  m_buffer.append(input);
+  m_framing.append(m_socket->readAll());
 
-  while (true) {
-    int pos = m_buffer.indexOf("\n");
-    if (pos == -1) {
-      break;
-    }
-
-    QByteArray line = m_buffer.left(pos);
-    m_buffer.remove(0, pos + 1);
-
-    QByteArray command(line);
-    command = command.trimmed();
-
-    if (command.isEmpty()) {
-      continue;
-    }
-
-    parseCommand(command);
+  QJsonObject obj;
+  while (m_framing.readMessage(obj)) {
+    parseCommand(obj);
   }
 }
 
-void DaemonLocalServerConnection::parseCommand(const QByteArray& data) {
-  logger.log() << "Command received:" << data.left(20);
-
-  QJsonDocument json = QJsonDocument::fromJson(data);
-  if (!json.isObject()) {
-    logger.log() << "Invalid input";
-    return;
-  }
-
-  QJsonObject obj = json.object();
+void DaemonLocalServerConnection::parseCommand(const QJsonObject& obj) {
   QJsonValue typeValue = obj.value("type");
   if (!typeValue.isString()) {
     logger.log() << "No type command. Ignoring request.";
@@ -88,6 +64,8 @@ void DaemonLocalServerConnection::parseCommand(const QByteArray& data) {
   }
 
   QString type = typeValue.toString();
+  logger.log() << "Command received:" << type;
+
   if (type == "activate") {
     InterfaceConfig config;
     if (!Daemon::parseConfig(obj, config)) {
@@ -109,17 +87,45 @@ void DaemonLocalServerConnection::parseCommand(const QByteArray& data) {
   }
 
   if (type == "status") {
-    m_socket->write(Daemon::instance()->getStatus());
+    if (!m_framing.framesEnabled() &&
+        obj.value("framing").toInt() >= LocalSocketFraming::FRAMING_VERSION) {
+      QJsonObject framing;
+      framing.insert("type", "framing");
+      framing.insert("version", LocalSocketFraming::FRAMING_VERSION);
+      write(framing);
+
+      m_framing.enableFrames();
+    }
+
+    QJsonObject status = Daemon::instance()->getStatus();
+    if (m_framing.framesEnabled()) {
+      write(status);
+      return;
+    }
+
+    m_socket->write(QJsonDocument(status).toJson(QJsonDocument::Compact));
     m_socket->write("\n");
     return;
   }
 
   if (type == "logs") {
+    // Clients sending a cursor receive the logs in chunks.
+    QJsonValue cursorValue = obj.value("cursor");
+    if (cursorValue.isString()) {
+      QString nextCursor;
+      QJsonObject obj;
+      obj.insert("type", "logs");
+      obj.insert("logs", Daemon::instance()->logsChunk(cursorValue.toString(),
+                                                       nextCursor));
+      obj.insert("cursor", nextCursor);
+      write(obj);
+      return;
+    }
+
     QJsonObject obj;
     obj.insert("type", "logs");
     obj.insert("logs", Daemon::instance()->logs().replace("\n", "|"));
-    m_socket->write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
-    m_socket->write("\n");
+    write(obj);
     return;
   }
 
@@ -150,6 +156,5 @@ void DaemonLocalServerConnection::backendFailure() {
 }
 
 void DaemonLocalServerConnection::write(const QJsonObject& obj) {
-  m_socket->write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
-  m_socket->write("\n");
+  m_socket->write(m_framing.serialize(obj));
 }
@@ -5,6 +5,8 @@
 #ifndef DAEMONLOCALSERVERCONNECTION_H
 #define DAEMONLOCALSERVERCONNECTION_H
 
+#include "localsocketframing.h"
+
 #include <QObject>
 
 class QLocalSocket;
@@ -19,7 +21,7 @@ class DaemonLocalServerConnection final : public QObject {
  private:
   void readData();
 
-  void parseCommand(const QByteArray& json);
+  void parseCommand(const QJsonObject& obj);
 
   void connected();
   void disconnected();
@@ -30,7 +32,7 @@ class DaemonLocalServerConnection final : public QObject {
  private:
   QLocalSocket* m_socket = nullptr;
 
-  QByteArray m_buffer;
+  LocalSocketFraming m_framing;
 };
 
 #endif  // DAEMONLOCALSERVERCONNECTION_H
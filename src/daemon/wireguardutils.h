@@ -18,7 +18,7 @@ class WireguardUtils : public QObject {
 
  public:
   struct peerBytes {
-    double txBytes, rxBytes;
+    uint64_t txBytes, rxBytes;
   };
 
   explicit WireguardUtils(QObject* parent) : QObject(parent){};
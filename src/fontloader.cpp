@@ -4,6 +4,7 @@
 
 #include "fontloader.h"
 #include "logger.h"
+#include "startuptimeline.h"
 
 #include <QDir>
 #include <QFontDatabase>
@@ -14,6 +15,7 @@ Logger logger(LOG_MAIN, "FontLoader");
 
 // static
 void FontLoader::loadFonts() {
+  StartupTimeline::Span span("FontLoader::loadFonts");
   QDir dir(":/ui/resources/fonts");
   QStringList files = dir.entryList();
   for (const QString& file : files) {
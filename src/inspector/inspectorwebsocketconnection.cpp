@@ -3,13 +3,16 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "inspectorwebsocketconnection.h"
+#include "captiveportal/captiveportalrequest.h"
 #include "leakdetector.h"
 #include "localizer.h"
 #include "logger.h"
 #include "loghandler.h"
 #include "mozillavpn.h"
+#include "networkrequeststats.h"
 #include "qmlengineholder.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 #include "systemtrayhandler.h"
 
 #ifdef QT_DEBUG
@@ -354,6 +357,8 @@ static QList<WebSocketCommand> s_commands{
     WebSocketCommand{"force_captive_portal_check",
                      "Force a captive portal check", 0,
                      [](const QList<QByteArray>&) {
+                       // A forced check must not reuse a cached result.
+                       CaptivePortalRequest::clearCache();
                        MozillaVPN::instance()
                            ->captivePortalDetection()
                            ->detectCaptivePortal();
@@ -552,6 +557,41 @@ static QList<WebSocketCommand> s_commands{
                        return obj;
                      }},
 
+    WebSocketCommand{"tasks", "Returns the task queue depth and wait times", 0,
+                     [](const QList<QByteArray>&) {
+                       QJsonObject obj;
+                       obj["value"] =
+                           MozillaVPN::instance()->taskScheduler()->status();
+                       return obj;
+                     }},
+
+    WebSocketCommand{"startup_time",
+                     "Returns the msecs from the startup to the first frame",
+                     0,
+                     [](const QList<QByteArray>&) {
+                       QJsonObject obj;
+                       obj["value"] = (double)QmlEngineHolder::instance()
+                                          ->firstFrameMsec();
+                       return obj;
+                     }},
+
+    WebSocketCommand{"startup_trace",
+                     "Returns the startup timeline in the Chrome trace format",
+                     0,
+                     [](const QList<QByteArray>&) {
+                       QJsonObject obj;
+                       obj["value"] = StartupTimeline::toChromeTrace();
+                       return obj;
+                     }},
+
+    WebSocketCommand{"network_stats",
+                     "Returns the latency and size of the network requests", 0,
+                     [](const QList<QByteArray>&) {
+                       QJsonObject obj;
+                       obj["value"] = NetworkRequestStats::status();
+                       return obj;
+                     }},
+
     WebSocketCommand{
         "reset_surveys",
         "Reset the list of triggered surveys and the installation time", 0,
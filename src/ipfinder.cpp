@@ -18,12 +18,34 @@
 #include <QJsonValue>
 #include <QUrl>
 
+// Delay before racing the next address of the same family.
+constexpr uint32_t IPFINDER_STAGGER_MSEC = 250;
+
+// How long to wait for the second family once the first one has answered.
+constexpr uint32_t IPFINDER_GRACE_MSEC = 1500;
+
 namespace {
 Logger logger(LOG_NETWORKING, "IPFinder");
 }
 
 IPFinder::IPFinder(QObject* parent) : QObject(parent) {
   MVPN_COUNT_CTOR(IPFinder);
+
+  connect(&m_staggerTimer, &QTimer::timeout, [this]() {
+    startNextRequest(IPv4);
+    startNextRequest(IPv6);
+
+    if (m_pendingAddresses[IPv4].isEmpty() &&
+        m_pendingAddresses[IPv6].isEmpty()) {
+      m_staggerTimer.stop();
+    }
+  });
+
+  m_graceTimer.setSingleShot(true);
+  connect(&m_graceTimer, &QTimer::timeout, [this]() {
+    logger.log() << "Grace period expired";
+    completeLookup();
+  });
 }
 
 IPFinder::~IPFinder() {
@@ -60,36 +82,50 @@ void IPFinder::dnsLookupCompleted(const QHostInfo& hostInfo) {
 
     if (address.protocol() == QAbstractSocket::IPv4Protocol) {
       logger.log() << "Ipv4:" << address.toString();
-      createRequest(address, false);
+      m_pendingAddresses[IPv4].append(address);
     }
 
     if (address.protocol() == QAbstractSocket::IPv6Protocol && ipv6Enabled) {
       logger.log() << "Ipv6:" << address.toString();
-      createRequest(address, true);
+      m_pendingAddresses[IPv6].append(address);
     }
   }
 
-  if (m_requestCount == 0) {
+  if (m_pendingAddresses[IPv4].isEmpty() &&
+      m_pendingAddresses[IPv6].isEmpty()) {
     logger.log() << "No requests created. Let's abort the lookup";
     emit completed(QString(), QString(), QString());
     deleteLater();
     return;
   }
+
+  startNextRequest(IPv4);
+  startNextRequest(IPv6);
+
+  if (!m_pendingAddresses[IPv4].isEmpty() ||
+      !m_pendingAddresses[IPv6].isEmpty()) {
+    m_staggerTimer.start(IPFINDER_STAGGER_MSEC);
+  }
 }
 
-void IPFinder::createRequest(const QHostAddress& address, bool ipv6) {
-  NetworkRequest* request = NetworkRequest::createForIpInfo(this, address);
+void IPFinder::startNextRequest(Family family) {
+  if (m_completed || !m_ipAddresses[family].isEmpty() ||
+      m_pendingAddresses[family].isEmpty()) {
+    return;
+  }
 
-  ++m_requestCount;
+  createRequest(m_pendingAddresses[family].takeFirst(), family);
+}
 
-  connect(request, &NetworkRequest::requestFailed,
-          [this](QNetworkReply::NetworkError error, const QByteArray&) {
-            logger.log() << "IP address request failed" << error;
+void IPFinder::createRequest(const QHostAddress& address, Family family) {
+  NetworkRequest* request = NetworkRequest::createForIpInfo(this, address);
+  m_requests.insert(request, family);
 
-            // This lookup has been canceled in the meantime.
-            if (m_requestCount == 0) {
-              return;
-            }
+  // The lambdas are bound to this object: abortRequests() disconnects them.
+  connect(request, &NetworkRequest::requestFailed, this,
+          [this, request, family](QNetworkReply::NetworkError error,
+                                  const QByteArray&) {
+            logger.log() << "IP address request failed" << error;
 
             ErrorHandler::ErrorType errorType =
                 ErrorHandler::toErrorType(error);
@@ -97,67 +133,97 @@ void IPFinder::createRequest(const QHostAddress& address, bool ipv6) {
               MozillaVPN::instance()->errorHandle(errorType);
             }
 
-            m_requestCount = 0;
-            emit completed(QString(), QString(), QString());
+            requestFailed(request, family);
           });
 
-  connect(request, &NetworkRequest::requestCompleted,
-          [this, ipv6](const QByteArray& data) {
+  connect(request, &NetworkRequest::requestCompleted, this,
+          [this, request, family](const QByteArray& data) {
             logger.log() << "IP address request completed";
+            requestCompleted(request, family, data);
+          });
+}
 
-            // This lookup has been canceled in the meantime.
-            if (m_requestCount == 0) {
-              return;
-            }
+void IPFinder::requestFailed(NetworkRequest* request, Family family) {
+  m_requests.remove(request);
 
-            QJsonDocument json = QJsonDocument::fromJson(data);
-            if (json.isObject()) {
-              QJsonObject obj = json.object();
+  // Do not wait for the stagger: the next address can be tried now.
+  startNextRequest(family);
+  maybeCompleteLookup();
+}
 
-              QJsonValue country = obj.take("country");
-              QJsonValue value = obj.value("ip");
+void IPFinder::requestCompleted(NetworkRequest* request, Family family,
+                                const QByteArray& data) {
+  m_requests.remove(request);
 
-              m_results.append(IPLookup{country.toString().toLower(),
-                                        value.toString(), ipv6});
-            }
+  QJsonDocument json = QJsonDocument::fromJson(data);
+  QJsonObject obj = json.object();
+  QString ipAddress = obj.value("ip").toString();
 
-            --m_requestCount;
-            if (m_requestCount == 0) {
-              completeLookup();
-            }
-          });
-}
+  if (ipAddress.isEmpty()) {
+    startNextRequest(family);
+    maybeCompleteLookup();
+    return;
+  }
 
-void IPFinder::completeLookup() {
-  Q_ASSERT(m_requestCount == 0);
+  m_ipAddresses[family] = ipAddress;
+  if (m_country.isEmpty()) {
+    m_country = obj.value("country").toString().toLower();
+  }
 
-  logger.log() << "Lookup completed!";
+  // We have a winner for this family.
+  m_pendingAddresses[family].clear();
+  abortRequests(family);
 
-  QString ipv4Address;
-  QString ipv6Address;
-  QString country;
+  maybeCompleteLookup();
+}
 
-  // In theory, we should have one ipv4 result and maybe an ipv6 too, but we do
-  // not know how the API host has been resolved. Let's use only the first
-  // result per type.
-  for (const IPLookup& ipLookup : m_results) {
-    if (ipLookup.m_ipAddress.isEmpty()) {
-      continue;
-    }
+void IPFinder::abortRequests(Family family) {
+  for (NetworkRequest* request : m_requests.keys(family)) {
+    m_requests.remove(request);
 
-    if (ipLookup.m_ipv6 && ipv6Address.isEmpty()) {
-      ipv6Address = ipLookup.m_ipAddress;
-    }
+    request->disconnect(this);
+    request->abort();
+  }
+}
 
-    if (!ipLookup.m_ipv6 && ipv4Address.isEmpty()) {
-      ipv4Address = ipLookup.m_ipAddress;
-    }
+void IPFinder::maybeCompleteLookup() {
+  if (m_completed) {
+    return;
+  }
 
-    if (country.isEmpty()) {
-      country = ipLookup.m_country;
+  bool answered = false;
+  bool racing = false;
+  for (Family family : {IPv4, IPv6}) {
+    if (!m_ipAddresses[family].isEmpty()) {
+      answered = true;
+    } else if (!m_pendingAddresses[family].isEmpty() ||
+               !m_requests.keys(family).isEmpty()) {
+      racing = true;
     }
   }
 
-  emit completed(ipv4Address, ipv6Address, country);
+  if (!racing) {
+    completeLookup();
+    return;
+  }
+
+  if (answered && !m_graceTimer.isActive()) {
+    m_graceTimer.start(IPFINDER_GRACE_MSEC);
+  }
+}
+
+void IPFinder::completeLookup() {
+  Q_ASSERT(!m_completed);
+  m_completed = true;
+
+  logger.log() << "Lookup completed!";
+
+  m_staggerTimer.stop();
+  m_graceTimer.stop();
+
+  abortRequests(IPv4);
+  abortRequests(IPv6);
+
+  emit completed(m_ipAddresses[IPv4], m_ipAddresses[IPv6], m_country);
   deleteLater();
 }
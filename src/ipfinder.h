@@ -5,11 +5,22 @@
 #ifndef IPFINDER_H
 #define IPFINDER_H
 
+#include <QHash>
+#include <QHostAddress>
 #include <QObject>
+#include <QTimer>
 
-class QHostAddress;
+class NetworkRequest;
 class QHostInfo;
 
+// The API host can resolve to several addresses per family. The requests of
+// the same family race: the first address is tried immediately, the next one
+// after a short stagger or as soon as the previous one fails. The first answer
+// per family wins and the other requests of that family are aborted.
+//
+// The lookup completes when every family has an answer or has run out of
+// addresses. Once a family has answered, the other has a short grace period.
+
 class IPFinder final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(IPFinder)
@@ -28,19 +39,36 @@ class IPFinder final : public QObject {
   void dnsLookupCompleted(const QHostInfo& hostInfo);
 
  private:
-  void createRequest(const QHostAddress& address, bool ipv6);
+  enum Family {
+    IPv4,
+    IPv6,
+  };
+
+  void startNextRequest(Family family);
+  void createRequest(const QHostAddress& address, Family family);
+  void requestFailed(NetworkRequest* request, Family family);
+  void requestCompleted(NetworkRequest* request, Family family,
+                        const QByteArray& data);
+  void abortRequests(Family family);
+  void maybeCompleteLookup();
   void completeLookup();
 
  private:
-  struct IPLookup {
-    QString m_country;
-    QString m_ipAddress;
-    bool m_ipv6;
-  };
+  QList<QHostAddress> m_pendingAddresses[IPv6 + 1];
+  QString m_ipAddresses[IPv6 + 1];
+  QString m_country;
 
-  QList<IPLookup> m_results;
-  uint32_t m_requestCount = 0;
+  QHash<NetworkRequest*, Family> m_requests;
+
+  QTimer m_staggerTimer;
+  QTimer m_graceTimer;
+
+  bool m_completed = false;
   int m_lookupId = -1;
+
+#ifdef UNIT_TEST
+  friend class TestIpFinder;
+#endif
 };
 
 #endif  // IPFINDER_H
@@ -16,7 +16,6 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QJsonArray>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QStandardPaths>
@@ -149,6 +148,9 @@ void LocalSocketController::checkStatus() {
 
     QJsonObject json;
     json.insert("type", "status");
+    if (!m_framing.framesEnabled()) {
+      json.insert("framing", LocalSocketFraming::FRAMING_VERSION);
+    }
     write(json);
   }
 }
@@ -175,6 +177,30 @@ void LocalSocketController::getBackendLogs(
   write(json);
 }
 
+void LocalSocketController::getBackendLogsChunk(
+    const QString& cursor,
+    std::function<void(const QString&, const QString&)>&& a_callback) {
+  logger.log() << "Backend logs chunk";
+
+  if (m_logChunkCallback) {
+    m_logChunkCallback("", "");
+    m_logChunkCallback = nullptr;
+  }
+
+  if (m_state != eReady) {
+    std::function<void(const QString&, const QString&)> callback = a_callback;
+    callback("", "");
+    return;
+  }
+
+  m_logChunkCallback = std::move(a_callback);
+
+  QJsonObject json;
+  json.insert("type", "logs");
+  json.insert("cursor", cursor);
+  write(json);
+}
+
 void LocalSocketController::cleanupBackendLogs() {
   logger.log() << "Cleanup logs";
 
@@ -183,6 +209,11 @@ void LocalSocketController::cleanupBackendLogs() {
     m_logCallback = nullptr;
   }
 
+  if (m_logChunkCallback) {
+    m_logChunkCallback("", "");
+    m_logChunkCallback = nullptr;
+  }
+
   if (m_state != eReady) {
     return;
   }
@@ -197,39 +228,15 @@ void LocalSocketController::readData() {
 
   Q_ASSERT(m_socket);
   Q_ASSERT(m_state == eInitializing || m_state == eReady);
-  QByteArray input = m_socket->readAll();
-  m_buffer.append(input);
+  m_framing.append(m_socket->readAll());
 
-  while (true) {
-    int pos = m_buffer.indexOf("\n");
-    if (pos == -1) {
-      break;
-    }
-
-    QByteArray line = m_buffer.left(pos);
-    m_buffer.remove(0, pos + 1);
-
-    QByteArray command(line);
-    command = command.trimmed();
-
-    if (command.isEmpty()) {
-      continue;
-    }
-
-    parseCommand(command);
+  QJsonObject obj;
+  while (m_framing.readMessage(obj)) {
+    parseCommand(obj);
   }
 }
 
-void LocalSocketController::parseCommand(const QByteArray& command) {
-  logger.log() << "Parse command:" << command.left(20);
-
-  QJsonDocument json = QJsonDocument::fromJson(command);
-  if (!json.isObject()) {
-    logger.log() << "Invalid JSON - object expected";
-    return;
-  }
-
-  QJsonObject obj = json.object();
+void LocalSocketController::parseCommand(const QJsonObject& obj) {
   QJsonValue typeValue = obj.value("type");
   if (!typeValue.isString()) {
     logger.log() << "Invalid JSON - no type";
@@ -237,6 +244,15 @@ void LocalSocketController::parseCommand(const QByteArray& command) {
   }
 
   QString type = typeValue.toString();
+  logger.log() << "Parse command:" << type;
+
+  // The daemon accepted the frames: the following messages use them.
+  if (type == "framing") {
+    if (obj.value("version").toInt() == LocalSocketFraming::FRAMING_VERSION) {
+      m_framing.enableFrames();
+    }
+    return;
+  }
 
   if (m_state == eInitializing && type == "status") {
     m_state = eReady;
@@ -318,23 +334,46 @@ void LocalSocketController::parseCommand(const QByteArray& command) {
   }
 
   if (type == "logs") {
+    QJsonValue logs = obj.value("logs");
+
+    // Chunked logs come with the cursor of the next chunk.
+    QJsonValue cursor = obj.value("cursor");
+
+    if (m_logChunkCallback) {
+      // The callback can request the next chunk: let's reset it first.
+      std::function<void(const QString&, const QString&)> callback =
+          std::move(m_logChunkCallback);
+      m_logChunkCallback = nullptr;
+
+      if (cursor.isString()) {
+        callback(logs.isString() ? logs.toString() : QString(),
+                 cursor.toString());
+        return;
+      }
+
+      // An older daemon ignores the cursor and sends all the logs at once.
+      // This is the last chunk.
+      callback(logs.isString() ? logs.toString().replace("|", "\n")
+                               : QString(),
+               QString());
+      return;
+    }
+
     // We don't care if we are not waiting for logs.
-    if (!m_logCallback) {
+    if (cursor.isString() || !m_logCallback) {
       return;
     }
 
-    QJsonValue logs = obj.value("logs");
     m_logCallback(logs.isString() ? logs.toString().replace("|", "\n")
                                   : QString());
     m_logCallback = nullptr;
     return;
   }
 
-  logger.log() << "Invalid command received:" << command;
+  logger.log() << "Invalid command received:" << type;
 }
 
 void LocalSocketController::write(const QJsonObject& json) {
   Q_ASSERT(m_socket);
-  m_socket->write(QJsonDocument(json).toJson(QJsonDocument::Compact));
-  m_socket->write("\n");
+  m_socket->write(m_framing.serialize(json));
 }
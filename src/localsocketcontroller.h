@@ -6,6 +6,7 @@
 #define LOCALSOCKETCONTROLLER_H
 
 #include "controllerimpl.h"
+#include "localsocketframing.h"
 
 #include <functional>
 #include <QLocalSocket>
@@ -31,13 +32,17 @@ class LocalSocketController final : public ControllerImpl {
 
   void getBackendLogs(std::function<void(const QString&)>&& callback) override;
 
+  void getBackendLogsChunk(
+      const QString& cursor,
+      std::function<void(const QString&, const QString&)>&& callback) override;
+
   void cleanupBackendLogs() override;
 
  private:
   void daemonConnected();
   void errorOccurred(QLocalSocket::LocalSocketError socketError);
   void readData();
-  void parseCommand(const QByteArray& command);
+  void parseCommand(const QJsonObject& obj);
 
   void write(const QJsonObject& json);
 
@@ -51,9 +56,11 @@ class LocalSocketController final : public ControllerImpl {
 
   QLocalSocket* m_socket = nullptr;
 
-  QByteArray m_buffer;
+  LocalSocketFraming m_framing;
 
   std::function<void(const QString&)> m_logCallback = nullptr;
+  std::function<void(const QString&, const QString&)> m_logChunkCallback =
+      nullptr;
 };
 
 #endif  // LOCALSOCKETCONTROLLER_H
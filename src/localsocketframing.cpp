@@ -0,0 +1,121 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "localsocketframing.h"
+#include "leakdetector.h"
+#include "logger.h"
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QtEndian>
+
+constexpr int FRAME_HEADER_SIZE = sizeof(quint32);
+constexpr quint32 FRAME_MAX_SIZE = 0x00FFFFFF;
+
+namespace {
+Logger logger(LOG_CONTROLLER, "LocalSocketFraming");
+}
+
+LocalSocketFraming::LocalSocketFraming() {
+  MVPN_COUNT_CTOR(LocalSocketFraming);
+}
+
+LocalSocketFraming::~LocalSocketFraming() {
+  MVPN_COUNT_DTOR(LocalSocketFraming);
+}
+
+QByteArray LocalSocketFraming::serialize(const QJsonObject& obj) const {
+  if (m_framesEnabled) {
+    QByteArray payload = QCborMap::fromJsonObject(obj).toCborValue().toCbor();
+
+    // The reader accepts JSON lines at any time.
+    if (static_cast<quint32>(payload.length()) <= FRAME_MAX_SIZE) {
+      QByteArray frame;
+      frame.reserve(FRAME_HEADER_SIZE + payload.length());
+      frame.resize(FRAME_HEADER_SIZE);
+      qToBigEndian<quint32>(payload.length(), frame.data());
+      frame.append(payload);
+      return frame;
+    }
+
+    logger.log() << "Message too big for a frame:" << payload.length();
+  }
+
+  QByteArray line = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+  line.append('\n');
+  return line;
+}
+
+void LocalSocketFraming::append(const QByteArray& data) {
+  if (m_cursor > 0) {
+    m_buffer.remove(0, m_cursor);
+    m_lineScan -= m_cursor;
+    m_cursor = 0;
+  }
+
+  m_buffer.append(data);
+}
+
+bool LocalSocketFraming::readMessage(QJsonObject& obj) {
+  while (m_cursor < m_buffer.length()) {
+    const char* data = m_buffer.constData() + m_cursor;
+    int available = m_buffer.length() - m_cursor;
+
+    if (data[0] == 0) {
+      if (available < FRAME_HEADER_SIZE) {
+        return false;
+      }
+
+      quint32 size = qFromBigEndian<quint32>(data);
+      if (size > FRAME_MAX_SIZE) {
+        logger.log() << "Invalid frame size. Dropping the buffer.";
+        m_buffer.clear();
+        m_cursor = 0;
+        m_lineScan = 0;
+        return false;
+      }
+
+      if (static_cast<quint32>(available - FRAME_HEADER_SIZE) < size) {
+        return false;
+      }
+
+      m_cursor += FRAME_HEADER_SIZE + size;
+      m_lineScan = m_cursor;
+
+      QCborValue value = QCborValue::fromCbor(
+          QByteArray::fromRawData(data + FRAME_HEADER_SIZE, size));
+      if (!value.isMap()) {
+        logger.log() << "Invalid frame - map expected";
+        continue;
+      }
+
+      obj = value.toMap().toJsonObject();
+      return true;
+    }
+
+    int pos = m_buffer.indexOf('\n', qMax(m_cursor, m_lineScan));
+    if (pos == -1) {
+      m_lineScan = m_buffer.length();
+      return false;
+    }
+
+    QByteArray line = QByteArray::fromRawData(data, pos - m_cursor);
+    m_cursor = pos + 1;
+    m_lineScan = m_cursor;
+
+    QJsonDocument json = QJsonDocument::fromJson(line);
+    if (!json.isObject()) {
+      if (!line.trimmed().isEmpty()) {
+        logger.log() << "Invalid JSON - object expected";
+      }
+      continue;
+    }
+
+    obj = json.object();
+    return true;
+  }
+
+  return false;
+}
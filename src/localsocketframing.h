@@ -0,0 +1,53 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef LOCALSOCKETFRAMING_H
+#define LOCALSOCKETFRAMING_H
+
+#include <QByteArray>
+#include <QJsonObject>
+
+// Messages exchanged by the client and the daemon on the local socket.
+//
+// The original protocol sends one compact JSON object per line. Since
+// version 1, a message can also be a frame: a 32-bit big-endian size followed
+// by a CBOR map. Frames are smaller than 16MB, so their first byte is always
+// 0 and the reader can tell the two formats apart message by message.
+//
+// The client proposes the frames adding "framing": 1 to its "status" request.
+// A daemon supporting them replies with a "framing" message and uses frames
+// from then on. Older peers ignore the extra key and keep using JSON lines.
+
+class LocalSocketFraming final {
+  Q_DISABLE_COPY_MOVE(LocalSocketFraming)
+
+ public:
+  static constexpr int FRAMING_VERSION = 1;
+
+  LocalSocketFraming();
+  ~LocalSocketFraming();
+
+  bool framesEnabled() const { return m_framesEnabled; }
+  void enableFrames() { m_framesEnabled = true; }
+
+  QByteArray serialize(const QJsonObject& obj) const;
+
+  void append(const QByteArray& data);
+
+  // Returns false if the buffer does not contain a complete message.
+  bool readMessage(QJsonObject& obj);
+
+ private:
+  // The buffer is compacted only when new data is appended: the messages are
+  // read moving a cursor.
+  QByteArray m_buffer;
+  int m_cursor = 0;
+
+  // Where to resume the search for the end of a partial JSON line.
+  int m_lineScan = 0;
+
+  bool m_framesEnabled = false;
+};
+
+#endif  // LOCALSOCKETFRAMING_H
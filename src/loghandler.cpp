@@ -6,28 +6,144 @@
 #include "logger.h"
 
 #include <QDate>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QMessageLogContext>
 #include <QMutexLocker>
 #include <QProcessEnvironment>
+#include <QRegularExpression>
 #include <QStandardPaths>
 #include <QString>
 #include <QTextStream>
+#include <QThreadPool>
+
+#include <algorithm>
 
 #ifdef MVPN_ANDROID
 #  include <android/log.h>
 #endif
 
+// Size of a single log segment. When the active log file grows beyond this
+// value, it is closed and a new one is started.
 constexpr qint64 LOG_MAX_FILE_SIZE = 204800;
+
+// Default cap for the whole set of segments, the active one included. It can
+// be changed via the MOZVPN_LOG_MAX_SIZE env variable (in KB).
+constexpr qint64 LOG_MAX_TOTAL_SIZE = 2097152;
+
 constexpr const char* LOG_FILENAME = "mozillavpn.txt";
 
+// Closed segments are named `mozillavpn-<sequence>.txt` or, if compressed,
+// `mozillavpn-<sequence>.txt.z`.
+constexpr const char* LOG_SEGMENT_PREFIX = "mozillavpn-";
+constexpr const char* LOG_SEGMENT_SUFFIX = ".txt";
+constexpr const char* LOG_COMPRESSED_SUFFIX = ".z";
+
+// Chunk size used to stream the segments out.
+constexpr qint64 LOG_READ_CHUNK_SIZE = 65536;
+
 namespace {
 QMutex s_mutex;
 QString s_location =
     QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
 LogHandler* s_instance = nullptr;
+
+// The uncompressed content of the compressed segment being streamed out, so
+// that it is decompressed once and not for every chunk. Guarded by s_mutex.
+QString s_uncompressedName;
+QDateTime s_uncompressedLastModified;
+QByteArray s_uncompressedContent;
+
+const QRegularExpression s_segmentRegExp(
+    QString("^%1(\\d+)%2(%3)?$")
+        .arg(QRegularExpression::escape(LOG_SEGMENT_PREFIX),
+             QRegularExpression::escape(LOG_SEGMENT_SUFFIX),
+             QRegularExpression::escape(LOG_COMPRESSED_SUFFIX)));
+
+quint64 segmentSequence(const QString& fileName) {
+  QRegularExpressionMatch match = s_segmentRegExp.match(fileName);
+  Q_ASSERT(match.hasMatch());
+  return match.captured(1).toULongLong();
+}
+
+// A cursor is the sequence number of a segment and the offset in its
+// uncompressed content. The active log file uses the sequence number it will
+// get when rotated, so that a cursor survives the rotation.
+QString formatCursor(quint64 sequence, qint64 offset) {
+  return QString("%1:%2").arg(sequence).arg(offset);
+}
+
+void parseCursor(const QString& cursor, quint64& sequence, qint64& offset) {
+  sequence = 0;
+  offset = 0;
+
+  QStringList parts = cursor.split(":");
+  if (parts.length() != 2) {
+    return;
+  }
+
+  bool ok = false;
+  quint64 s = parts[0].toULongLong(&ok);
+  if (!ok) {
+    return;
+  }
+
+  qint64 o = parts[1].toLongLong(&ok);
+  if (!ok || o < 0) {
+    return;
+  }
+
+  sequence = s;
+  offset = o;
+}
+
+// Runs on a worker thread: the logging threads do not wait for the
+// compression. The compressed segment replaces the plain one only if the
+// latter has not been dropped or recreated in the meantime.
+void compressSegment(const QString& segmentName) {
+  QFileInfo info(segmentName);
+  QDateTime lastModified = info.lastModified();
+  qint64 size = info.size();
+
+  QByteArray data;
+  {
+    QFile file(segmentName);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return;
+    }
+    data = qCompress(file.readAll());
+  }
+
+  QString compressedName = segmentName + LOG_COMPRESSED_SUFFIX;
+  QString tmpName = compressedName + ".tmp";
+  {
+    QFile tmp(tmpName);
+    if (!tmp.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        tmp.write(data) != data.length()) {
+      tmp.remove();
+      return;
+    }
+  }
+
+  QMutexLocker lock(&s_mutex);
+
+  info.refresh();
+  if (!info.exists() || info.size() != size ||
+      info.lastModified() != lastModified) {
+    QFile::remove(tmpName);
+    return;
+  }
+
+  QFile::remove(compressedName);
+  if (!QFile::rename(tmpName, compressedName)) {
+    QFile::remove(tmpName);
+    return;
+  }
+
+  QFile::remove(segmentName);
+}
 }  // namespace
 
 // static
@@ -65,7 +181,20 @@ LogHandler* LogHandler::maybeCreate(const QMutexLocker& proofOfLock) {
       }
     }
 
-    s_instance = new LogHandler(modules, proofOfLock);
+    qint64 maxTotalSize = LOG_MAX_TOTAL_SIZE;
+    if (pe.contains("MOZVPN_LOG_MAX_SIZE")) {
+      bool ok = false;
+      qint64 value = pe.value("MOZVPN_LOG_MAX_SIZE").toLongLong(&ok) * 1024;
+      if (ok && value >= LOG_MAX_FILE_SIZE) {
+        maxTotalSize = value;
+      }
+    }
+
+    bool compressSegments = pe.contains("MOZVPN_LOG_COMPRESS") &&
+                            pe.value("MOZVPN_LOG_COMPRESS") != "0";
+
+    s_instance =
+        new LogHandler(modules, maxTotalSize, compressSegments, proofOfLock);
   }
 
   return s_instance;
@@ -129,9 +258,11 @@ void LogHandler::prettyOutput(QTextStream& out, const LogHandler::Log& log) {
   out << Qt::endl;
 }
 
-LogHandler::LogHandler(const QStringList& modules,
-                       const QMutexLocker& proofOfLock)
-    : m_modules(modules) {
+LogHandler::LogHandler(const QStringList& modules, qint64 maxTotalSize,
+                       bool compressSegments, const QMutexLocker& proofOfLock)
+    : m_modules(modules),
+      m_maxTotalSize(maxTotalSize),
+      m_compressSegments(compressSegments) {
   Q_UNUSED(proofOfLock);
 
   if (!s_location.isEmpty()) {
@@ -146,6 +277,7 @@ void LogHandler::addLog(const Log& log, const QMutexLocker& proofOfLock) {
 
   if (m_output) {
     prettyOutput(*m_output, log);
+    maybeRotateLogFile(proofOfLock);
   }
 
 #if defined(MVPN_ANDROID) || defined(MVPN_INSPECTOR)
@@ -203,19 +335,125 @@ void LogHandler::writeLogs(QTextStream& out) {
     return;
   }
 
-  QString logFileName = s_instance->m_logFile->fileName();
-  s_instance->closeLogFile(lock);
+  // The segments are streamed oldest first, followed by the active one.
+  QStringList files = logSegments(lock);
+  files.append(s_instance->m_logFile->fileName());
 
-  {
-    QFile file(logFileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-      return;
+  s_instance->m_output->flush();
+
+  for (const QString& fileName : files) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+      continue;
+    }
+
+    if (fileName.endsWith(LOG_COMPRESSED_SUFFIX)) {
+      out << qUncompress(file.readAll());
+      continue;
+    }
+
+    // The chunks are converted from UTF-8 one by one: they must end on a line
+    // boundary, or a multi-byte sequence could be split.
+    while (!file.atEnd()) {
+      QByteArray chunk = file.read(LOG_READ_CHUNK_SIZE);
+      if (!chunk.endsWith('\n')) {
+        chunk.append(file.readLine());
+      }
+      out << chunk;
+    }
+  }
+}
+
+// static
+QByteArray LogHandler::readLogChunk(const QString& cursor,
+                                    QString& nextCursor) {
+  QMutexLocker lock(&s_mutex);
+
+  nextCursor.clear();
+
+  if (!s_instance || !s_instance->m_logFile) {
+    return QByteArray();
+  }
+
+  s_instance->m_output->flush();
+
+  quint64 sequence;
+  qint64 offset;
+  parseCursor(cursor, sequence, offset);
+
+  QStringList segments = logSegments(lock);
+
+  // Let's find the first file with a sequence number equal or greater than
+  // the cursor one. If the cursor segment has been dropped in the meantime,
+  // we continue from the oldest available one.
+  QString fileName;
+  quint64 fileSequence = 0;
+  bool activeFile = true;
+  for (const QString& segment : segments) {
+    fileSequence = segmentSequence(QFileInfo(segment).fileName());
+    if (fileSequence >= sequence) {
+      fileName = segment;
+      activeFile = false;
+      break;
     }
+  }
+
+  if (activeFile) {
+    fileName = s_instance->m_logFile->fileName();
+    fileSequence =
+        segments.isEmpty()
+            ? 0
+            : segmentSequence(QFileInfo(segments.last()).fileName()) + 1;
+  }
 
-    out << file.readAll();
+  if (fileSequence != sequence) {
+    offset = 0;
   }
 
-  s_instance->openLogFile(lock);
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return QByteArray();
+  }
+
+  QByteArray chunk;
+  bool atEnd = false;
+
+  if (fileName.endsWith(LOG_COMPRESSED_SUFFIX)) {
+    QDateTime lastModified = QFileInfo(file).lastModified();
+    if (s_uncompressedName != fileName ||
+        s_uncompressedLastModified != lastModified) {
+      s_uncompressedName = fileName;
+      s_uncompressedLastModified = lastModified;
+      s_uncompressedContent = qUncompress(file.readAll());
+    }
+
+    chunk = s_uncompressedContent.mid(offset, LOG_READ_CHUNK_SIZE);
+    atEnd = offset + chunk.length() >= s_uncompressedContent.length();
+
+    if (atEnd) {
+      s_uncompressedName.clear();
+      s_uncompressedContent.clear();
+    }
+  } else {
+    if (offset > file.size() || !file.seek(offset)) {
+      offset = 0;
+      file.seek(0);
+    }
+    chunk = file.read(LOG_READ_CHUNK_SIZE);
+    atEnd = file.atEnd();
+  }
+
+  if (!atEnd) {
+    int pos = chunk.lastIndexOf('\n');
+    if (pos != -1) {
+      chunk.truncate(pos + 1);
+    }
+    nextCursor = formatCursor(fileSequence, offset + chunk.length());
+  } else if (!activeFile) {
+    nextCursor = formatCursor(fileSequence + 1, 0);
+  }
+
+  return chunk;
 }
 
 // static
@@ -233,6 +471,13 @@ void LogHandler::cleanupLogFile(const QMutexLocker& proofOfLock) {
   QString logFileName = s_instance->m_logFile->fileName();
   s_instance->closeLogFile(proofOfLock);
 
+  for (const QString& segment : logSegments(proofOfLock)) {
+    QFile::remove(segment);
+  }
+
+  s_uncompressedName.clear();
+  s_uncompressedContent.clear();
+
   {
     QFile file(logFileName);
     file.remove();
@@ -270,9 +515,6 @@ void LogHandler::openLogFile(const QMutexLocker& proofOfLock) {
 
   QString logFileName = appDataLocation.filePath(LOG_FILENAME);
   m_logFile = new QFile(logFileName);
-  if (m_logFile->size() > LOG_MAX_FILE_SIZE) {
-    m_logFile->remove();
-  }
 
   if (!m_logFile->open(QIODevice::WriteOnly | QIODevice::Append |
                        QIODevice::Text)) {
@@ -299,3 +541,95 @@ void LogHandler::closeLogFile(const QMutexLocker& proofOfLock) {
     m_logFile = nullptr;
   }
 }
+
+void LogHandler::maybeRotateLogFile(const QMutexLocker& proofOfLock) {
+  Q_ASSERT(m_logFile);
+
+  // openLogFile() writes the first line of the new segment through addLog().
+  if (m_rotating || m_logFile->size() < LOG_MAX_FILE_SIZE) {
+    return;
+  }
+
+  m_rotating = true;
+
+  QString logFileName = m_logFile->fileName();
+  closeLogFile(proofOfLock);
+
+  quint64 sequence = 0;
+  QStringList segments = logSegments(proofOfLock);
+  if (!segments.isEmpty()) {
+    sequence = segmentSequence(QFileInfo(segments.last()).fileName()) + 1;
+  }
+
+  QDir logDir = QFileInfo(logFileName).dir();
+  QString segmentName =
+      logDir.filePath(QString("%1%2%3")
+                          .arg(LOG_SEGMENT_PREFIX)
+                          .arg(sequence)
+                          .arg(LOG_SEGMENT_SUFFIX));
+
+  // The segment is just renamed here: no data is copied on the write path.
+  QFile::remove(segmentName);
+  bool renamed = QFile::rename(logFileName, segmentName);
+
+  enforceSegmentQuota(proofOfLock);
+
+  openLogFile(proofOfLock);
+  m_rotating = false;
+
+  if (renamed && m_compressSegments) {
+    QThreadPool::globalInstance()->start(
+        [segmentName]() { compressSegment(segmentName); });
+  }
+}
+
+void LogHandler::enforceSegmentQuota(const QMutexLocker& proofOfLock) {
+  // The active segment can grow up to LOG_MAX_FILE_SIZE.
+  qint64 available = m_maxTotalSize - LOG_MAX_FILE_SIZE;
+
+  QStringList segments = logSegments(proofOfLock);
+
+  // Newest first: we keep what fits and we drop the oldest segments.
+  for (int i = segments.length() - 1; i >= 0; --i) {
+    qint64 size = QFileInfo(segments[i]).size();
+    if (size <= available) {
+      available -= size;
+      continue;
+    }
+
+    available = 0;
+    QFile::remove(segments[i]);
+  }
+}
+
+// static
+QStringList LogHandler::logSegments(const QMutexLocker& proofOfLock) {
+  Q_UNUSED(proofOfLock);
+
+  QDir logDir(s_location);
+  if (!logDir.exists()) {
+    return QStringList();
+  }
+
+  QStringList fileNames = logDir.entryList(
+      QStringList{QString("%1*").arg(LOG_SEGMENT_PREFIX)}, QDir::Files);
+
+  QList<QPair<quint64, QString>> segments;
+  for (const QString& fileName : fileNames) {
+    if (s_segmentRegExp.match(fileName).hasMatch()) {
+      segments.append(
+          qMakePair(segmentSequence(fileName), logDir.filePath(fileName)));
+    }
+  }
+
+  std::sort(segments.begin(), segments.end(),
+            [](const QPair<quint64, QString>& a,
+               const QPair<quint64, QString>& b) { return a.first < b.first; });
+
+  QStringList result;
+  for (const QPair<quint64, QString>& segment : segments) {
+    result.append(segment.second);
+  }
+
+  return result;
+}
@@ -62,6 +62,12 @@ class LogHandler final : public QObject {
 
   static void writeLogs(QTextStream& out);
 
+  // Returns a chunk of logs starting from `cursor` (empty for the first
+  // chunk). `nextCursor` is set to the position of the following chunk, or
+  // it is cleared when there is nothing else to read. Chunks always end on a
+  // line boundary.
+  static QByteArray readLogChunk(const QString& cursor, QString& nextCursor);
+
   static void cleanupLogs();
 
   static void setLocation(const QString& path);
@@ -70,7 +76,8 @@ class LogHandler final : public QObject {
   void logEntryAdded(const QByteArray& log);
 
  private:
-  LogHandler(const QStringList& modules, const QMutexLocker& proofOfLock);
+  LogHandler(const QStringList& modules, qint64 maxTotalSize,
+             bool compressSegments, const QMutexLocker& proofOfLock);
 
   static LogHandler* maybeCreate(const QMutexLocker& proofOfLock);
 
@@ -82,12 +89,23 @@ class LogHandler final : public QObject {
 
   void closeLogFile(const QMutexLocker& proofOfLock);
 
+  void maybeRotateLogFile(const QMutexLocker& proofOfLock);
+
+  void enforceSegmentQuota(const QMutexLocker& proofOfLock);
+
+  static QStringList logSegments(const QMutexLocker& proofOfLock);
+
   static void cleanupLogFile(const QMutexLocker& proofOfLock);
 
   const QStringList m_modules;
 
+  // The max size of all the log segments on disk, the active one included.
+  const qint64 m_maxTotalSize;
+  const bool m_compressSegments;
+
   QFile* m_logFile = nullptr;
   QTextStream* m_output = nullptr;
+  bool m_rotating = false;
 };
 
 #endif  // LOGHANDLER_H
@@ -7,6 +7,7 @@
 #include "logger.h"
 #include "mozillavpn.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -39,6 +40,8 @@ bool DeviceModel::fromJson(const Keys* keys, const QByteArray& s) {
 }
 
 bool DeviceModel::fromSettings(const Keys* keys) {
+  StartupTimeline::Span span("DeviceModel::fromSettings");
+
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
 
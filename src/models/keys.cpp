@@ -6,6 +6,7 @@
 #include "devicemodel.h"
 #include "leakdetector.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -17,6 +18,8 @@ Keys::Keys() { MVPN_COUNT_CTOR(Keys); }
 Keys::~Keys() { MVPN_COUNT_DTOR(Keys); }
 
 bool Keys::fromSettings() {
+  StartupTimeline::Span span("Keys::fromSettings");
+
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
 
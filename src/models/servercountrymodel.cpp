@@ -9,6 +9,7 @@
 #include "serverdata.h"
 #include "serveri18n.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 
 #include <QCollator>
 #include <QJsonArray>
@@ -29,6 +30,8 @@ ServerCountryModel::~ServerCountryModel() {
 }
 
 bool ServerCountryModel::fromSettings() {
+  StartupTimeline::Span span("ServerCountryModel::fromSettings");
+
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
 
@@ -66,6 +69,7 @@ bool ServerCountryModel::fromJson(const QByteArray& s) {
 bool ServerCountryModel::fromJsonInternal(const QByteArray& s) {
   beginResetModel();
 
+  ++m_revision;
   m_rawJson = "";
   m_countries.clear();
 
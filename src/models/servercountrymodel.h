@@ -55,6 +55,9 @@ class ServerCountryModel final : public QAbstractListModel {
   // For the web-extension
   const QByteArray& rawJson() const { return m_rawJson; }
 
+  // Changes each time the server list is replaced.
+  quint64 revision() const { return m_revision; }
+
   // QAbstractListModel methods
 
   QHash<int, QByteArray> roleNames() const override;
@@ -72,6 +75,7 @@ class ServerCountryModel final : public QAbstractListModel {
 
  private:
   QByteArray m_rawJson;
+  quint64 m_revision = 0;
 
   QList<ServerCountry> m_countries;
 };
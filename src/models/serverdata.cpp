@@ -8,6 +8,7 @@
 #include "servercountrymodel.h"
 #include "serveri18n.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 
 namespace {
 Logger logger(LOG_MODEL, "ServerData");
@@ -18,6 +19,8 @@ ServerData::ServerData() { MVPN_COUNT_CTOR(ServerData); }
 ServerData::~ServerData() { MVPN_COUNT_DTOR(ServerData); }
 
 bool ServerData::fromSettings() {
+  StartupTimeline::Span span("ServerData::fromSettings");
+
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
 
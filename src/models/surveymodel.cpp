@@ -7,6 +7,7 @@
 #include "leakdetector.h"
 #include "logger.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 #include "urlopener.h"
 
 #include <QJsonArray>
@@ -51,6 +52,8 @@ bool SurveyModel::fromJson(const QByteArray& s) {
 }
 
 bool SurveyModel::fromSettings() {
+  StartupTimeline::Span span("SurveyModel::fromSettings");
+
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
 
@@ -5,6 +5,7 @@
 #include "user.h"
 #include "leakdetector.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -81,6 +82,8 @@ bool User::fromJson(const QByteArray& json) {
 }
 
 bool User::fromSettings() {
+  StartupTimeline::Span span("User::fromSettings");
+
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
 
@@ -12,8 +12,10 @@
 #include "models/device.h"
 #include "models/servercountrymodel.h"
 #include "models/user.h"
+#include "networkrequeststats.h"
 #include "qmlengineholder.h"
 #include "settingsholder.h"
+#include "startuptimeline.h"
 #include "tasks/accountandservers/taskaccountandservers.h"
 #include "tasks/adddevice/taskadddevice.h"
 #include "tasks/authenticate/taskauthenticate.h"
@@ -123,6 +125,9 @@ MozillaVPN::MozillaVPN() : m_private(new Private()) {
           &m_private->m_captivePortalDetection,
           &CaptivePortalDetection::stateChanged);
 
+  connect(&m_private->m_networkWatcher, &NetworkWatcher::networkChanged,
+          &m_private->m_connectionHealth, &ConnectionHealth::networkChanged);
+
   connect(&m_private->m_connectionHealth, &ConnectionHealth::stabilityChanged,
           &m_private->m_captivePortalDetection,
           &CaptivePortalDetection::stateChanged);
@@ -139,6 +144,9 @@ MozillaVPN::MozillaVPN() : m_private(new Private()) {
   connect(this, &MozillaVPN::stateChanged, &m_private->m_connectionDataHolder,
           &ConnectionDataHolder::stateChanged);
 
+  connect(&m_private->m_controller, &Controller::stateChanged,
+          &m_private->m_throughputHistory, &ThroughputHistory::stateChanged);
+
 #ifdef MVPN_IOS
   IAPHandler* iap = IAPHandler::createInstance();
   connect(iap, &IAPHandler::subscriptionStarted, this,
@@ -172,6 +180,7 @@ MozillaVPN::~MozillaVPN() {
 MozillaVPN::State MozillaVPN::state() const { return m_state; }
 
 void MozillaVPN::initialize() {
+  StartupTimeline::Span span("MozillaVPN::initialize");
   logger.log() << "MozillaVPN Initialization";
 
   Q_ASSERT(!m_initialized);
@@ -209,6 +218,7 @@ void MozillaVPN::initialize() {
 
   m_private->m_captivePortalDetection.initialize();
   m_private->m_networkWatcher.initialize();
+  m_private->m_throughputHistory.initialize();
 
   if (!settingsHolder->hasToken()) {
     return;
@@ -438,38 +448,7 @@ void MozillaVPN::openLink(LinkType linkType) {
 }
 
 void MozillaVPN::scheduleTask(Task* task) {
-  Q_ASSERT(task);
-  logger.log() << "Scheduling task: " << task->name();
-
-  m_tasks.append(task);
-  maybeRunTask();
-}
-
-void MozillaVPN::maybeRunTask() {
-  logger.log() << "Tasks: " << m_tasks.size();
-
-  if (m_running_task || m_tasks.empty()) {
-    return;
-  }
-
-  m_running_task = m_tasks.takeFirst();
-  Q_ASSERT(m_running_task);
-
-  QObject::connect(m_running_task, &Task::completed, this,
-                   &MozillaVPN::taskCompleted);
-
-  m_running_task->run(this);
-}
-
-void MozillaVPN::taskCompleted() {
-  logger.log() << "Task completed";
-
-  Q_ASSERT(m_running_task);
-  m_running_task->deleteLater();
-  m_running_task->disconnect();
-  m_running_task = nullptr;
-
-  maybeRunTask();
+  m_private->m_taskScheduler.scheduleTask(task);
 }
 
 void MozillaVPN::setToken(const QString& token) {
@@ -558,19 +537,22 @@ void MozillaVPN::completeActivation() {
   scheduleTask(new TaskIOSProducts());
 #endif
 
-  // Finally we are able to activate the client.
-  scheduleTask(new TaskFunction([this](MozillaVPN*) {
-    if (!modelsInitialized()) {
-      logger.log() << "Failed to complete the authentication";
-      errorHandle(ErrorHandler::RemoteServiceError);
-      setUserAuthenticated(false);
-      return;
-    }
+  // Finally we are able to activate the client. This needs to wait for the
+  // account tasks only.
+  scheduleTask(new TaskFunction(
+      [this](MozillaVPN*) {
+        if (!modelsInitialized()) {
+          logger.log() << "Failed to complete the authentication";
+          errorHandle(ErrorHandler::RemoteServiceError);
+          setUserAuthenticated(false);
+          return;
+        }
 
-    Q_ASSERT(m_private->m_serverData.initialized());
+        Q_ASSERT(m_private->m_serverData.initialized());
 
-    maybeStateMain();
-  }));
+        maybeStateMain();
+      },
+      Task::GroupAccount));
 }
 
 void MozillaVPN::deviceAdded(const QString& deviceName,
@@ -593,6 +575,8 @@ void MozillaVPN::deviceRemoved(const QString& deviceName) {
 bool MozillaVPN::setServerList(const QByteArray& serverData) {
   if (!m_private->m_serverCountryModel.fromJson(serverData)) {
     logger.log() << "Failed to store the server-countries";
+    // Let's fetch the full response next time.
+    SettingsHolder::instance()->removeResponseValidators();
     return false;
   }
 
@@ -642,21 +626,23 @@ void MozillaVPN::removeDevice(const QString& deviceName) {
   scheduleTask(new TaskAccountAndServers());
 
   // Finally we are able to activate the client.
-  scheduleTask(new TaskFunction([this](MozillaVPN*) {
-    if (m_state != StateDeviceLimit) {
-      return;
-    }
+  scheduleTask(new TaskFunction(
+      [this](MozillaVPN*) {
+        if (m_state != StateDeviceLimit) {
+          return;
+        }
 
-    if (!modelsInitialized()) {
-      logger.log() << "Models not initialized yet";
-      errorHandle(ErrorHandler::RemoteServiceError);
-      SettingsHolder::instance()->clear();
-      setState(StateInitialize);
-      return;
-    }
+        if (!modelsInitialized()) {
+          logger.log() << "Models not initialized yet";
+          errorHandle(ErrorHandler::RemoteServiceError);
+          SettingsHolder::instance()->clear();
+          setState(StateInitialize);
+          return;
+        }
 
-    maybeStateMain();
-  }));
+        maybeStateMain();
+      },
+      Task::GroupAccount));
 }
 
 void MozillaVPN::accountChecked(const QByteArray& json) {
@@ -664,12 +650,14 @@ void MozillaVPN::accountChecked(const QByteArray& json) {
 
   if (!m_private->m_user.fromJson(json)) {
     logger.log() << "Failed to parse the User JSON data";
+    SettingsHolder::instance()->removeResponseValidators();
     // We don't need to communicate it to the user. Let's ignore it.
     return;
   }
 
   if (!m_private->m_deviceModel.fromJson(keys(), json)) {
     logger.log() << "Failed to parse the DeviceModel JSON data";
+    SettingsHolder::instance()->removeResponseValidators();
     // We don't need to communicate it to the user. Let's ignore it.
     return;
   }
@@ -693,6 +681,7 @@ void MozillaVPN::surveyChecked(const QByteArray& json) {
 
   if (!m_private->m_surveyModel.fromJson(json)) {
     logger.log() << "Failed to parse the Survey JSON data";
+    SettingsHolder::instance()->removeResponseValidators();
     return;
   }
 
@@ -751,19 +740,7 @@ void MozillaVPN::reset(bool forceInitialState) {
   }
 }
 
-void MozillaVPN::deleteTasks() {
-  for (Task* task : m_tasks) {
-    task->deleteLater();
-  }
-
-  m_tasks.clear();
-
-  if (m_running_task) {
-    m_running_task->deleteLater();
-    m_running_task->disconnect();
-    m_running_task = nullptr;
-  }
-}
+void MozillaVPN::deleteTasks() { m_private->m_taskScheduler.deleteTasks(); }
 
 void MozillaVPN::setAlert(AlertType alert) {
   m_alertTimer.stop();
@@ -1003,33 +980,57 @@ void MozillaVPN::serializeLogs(QTextStream* out,
 
   LogHandler::writeLogs(*out);
 
-  MozillaVPN::instance()->controller()->getBackendLogs(
-      [out,
-       finalizeCallback = std::move(finalizeCallback)](const QString& logs) {
-        logger.log() << "Logs from the backend service received";
-
-        *out << Qt::endl
-             << Qt::endl
-             << "Mozilla VPN backend logs" << Qt::endl
-             << "========================" << Qt::endl
-             << Qt::endl;
+  *out << Qt::endl
+       << Qt::endl
+       << "Mozilla VPN backend logs" << Qt::endl
+       << "========================" << Qt::endl
+       << Qt::endl;
 
-        if (!logs.isEmpty()) {
-          *out << logs;
-        } else {
-          *out << "No logs from the backend.";
-        }
+  serializeBackendLogs(
+      out, QString(), false,
+      [out, finalizeCallback = std::move(finalizeCallback)]() {
         *out << Qt::endl;
         *out << "==== SETTINGS ====" << Qt::endl;
         *out << SettingsHolder::instance()->getReport();
         *out << "==== DEVICE ====" << Qt::endl;
         *out << Device::currentDeviceReport();
+        *out << "==== NETWORK REQUESTS ====" << Qt::endl;
+        *out << NetworkRequestStats::report();
         *out << Qt::endl;
 
         finalizeCallback();
       });
 }
 
+void MozillaVPN::serializeBackendLogs(QTextStream* out, const QString& cursor,
+                                      bool hasLogs,
+                                      std::function<void()>&& a_callback) {
+  std::function<void()> callback = std::move(a_callback);
+
+  // The backend logs are written chunk by chunk, as they are received.
+  m_private->m_controller.getBackendLogsChunk(
+      cursor, [this, out, hasLogs, callback = std::move(callback)](
+                  const QString& logs, const QString& nextCursor) mutable {
+        logger.log() << "Logs from the backend service received";
+
+        if (!logs.isEmpty()) {
+          *out << logs;
+          hasLogs = true;
+        }
+
+        if (!nextCursor.isEmpty()) {
+          serializeBackendLogs(out, nextCursor, hasLogs, std::move(callback));
+          return;
+        }
+
+        if (!hasLogs) {
+          *out << "No logs from the backend.";
+        }
+
+        callback();
+      });
+}
+
 void MozillaVPN::viewLogs() {
   logger.log() << "View logs";
 
@@ -22,6 +22,8 @@
 #include "networkwatcher.h"
 #include "releasemonitor.h"
 #include "statusicon.h"
+#include "taskscheduler.h"
+#include "throughputhistory.h"
 
 #include <QList>
 #include <QNetworkReply>
@@ -157,11 +159,15 @@ class MozillaVPN final : public QObject {
   HelpModel* helpModel() { return &m_private->m_helpModel; }
   NetworkWatcher* networkWatcher() { return &m_private->m_networkWatcher; }
   ReleaseMonitor* releaseMonitor() { return &m_private->m_releaseMonitor; }
+  ThroughputHistory* throughputHistory() {
+    return &m_private->m_throughputHistory;
+  }
   ServerCountryModel* serverCountryModel() {
     return &m_private->m_serverCountryModel;
   }
   StatusIcon* statusIcon() { return &m_private->m_statusIcon; }
   SurveyModel* surveyModel() { return &m_private->m_surveyModel; }
+  TaskScheduler* taskScheduler() { return &m_private->m_taskScheduler; }
   User* user() { return &m_private->m_user; }
 
   // Called at the end of the authentication flow. We can continue adding the
@@ -226,7 +232,6 @@ class MozillaVPN final : public QObject {
   void maybeStateMain();
 
   void scheduleTask(Task* task);
-  void maybeRunTask();
   void deleteTasks();
 
   void setUserAuthenticated(bool state);
@@ -245,6 +250,9 @@ class MozillaVPN final : public QObject {
   void serializeLogs(QTextStream* out,
                      std::function<void()>&& finalizeCallback);
 
+  void serializeBackendLogs(QTextStream* out, const QString& cursor,
+                            bool hasLogs, std::function<void()>&& callback);
+
 #ifdef MVPN_IOS
   void subscriptionStarted();
   void subscriptionCompleted();
@@ -271,9 +279,6 @@ class MozillaVPN final : public QObject {
   void requestAbout();
   void requestViewLogs();
 
- private slots:
-  void taskCompleted();
-
  signals:
   void stateChanged();
   void alertChanged();
@@ -317,15 +322,13 @@ class MozillaVPN final : public QObject {
     ServerData m_serverData;
     StatusIcon m_statusIcon;
     SurveyModel m_surveyModel;
+    TaskScheduler m_taskScheduler;
+    ThroughputHistory m_throughputHistory;
     User m_user;
   };
 
   Private* m_private = nullptr;
 
-  // Task handling.
-  Task* m_running_task = nullptr;
-  QList<Task*> m_tasks;
-
   State m_state = StateInitialize;
   AlertType m_alert = NoAlert;
 
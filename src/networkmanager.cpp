@@ -6,6 +6,7 @@
 #include "constants.h"
 #include "leakdetector.h"
 
+#include <QNetworkAccessManager>
 #include <QTextStream>
 
 namespace {
@@ -63,7 +64,35 @@ QByteArray NetworkManager::userAgent() {
   return userAgent;
 }
 
+QNetworkAccessManager* NetworkManager::networkAccessManager(Pool pool) {
+  if (pool == ApiPool) {
+    return networkAccessManager();
+  }
+
+  Q_ASSERT(pool == ProbePool);
+  if (!m_probeManager) {
+    // The probes go through the same proxy and follow the same policies as
+    // the API requests. They have their own cookie jar and, as the API
+    // manager, no cache.
+    QNetworkAccessManager* apiManager = networkAccessManager();
+    Q_ASSERT(apiManager);
+
+    m_probeManager = new QNetworkAccessManager(this);
+    m_probeManager->setProxy(apiManager->proxy());
+    m_probeManager->setRedirectPolicy(apiManager->redirectPolicy());
+    m_probeManager->setStrictTransportSecurityEnabled(
+        apiManager->isStrictTransportSecurityEnabled());
+  }
+
+  return m_probeManager;
+}
+
 void NetworkManager::clearCache() {
+  // The TLS sessions belong to the connections we are dropping.
+  m_sslSessions[ApiPool].clear();
+
+  discardProbeNetworkAccessManager();
+
   if (m_requestCount == 0) {
     Q_ASSERT(m_clearCacheNeeded == false);
     clearCacheInternal();
@@ -73,9 +102,51 @@ void NetworkManager::clearCache() {
   m_clearCacheNeeded = true;
 }
 
-void NetworkManager::increaseNetworkRequestCount() { ++m_requestCount; }
+void NetworkManager::discardProbeNetworkAccessManager() {
+  if (m_probeRequestCount == 0) {
+    Q_ASSERT(m_discardProbeNeeded == false);
+    discardProbeNetworkAccessManagerInternal();
+    return;
+  }
+
+  m_discardProbeNeeded = true;
+}
+
+void NetworkManager::discardProbeNetworkAccessManagerInternal() {
+  m_sslSessions[ProbePool].clear();
+
+  if (!m_probeManager) {
+    return;
+  }
+
+  // The replies of the last probes can still be alive.
+  m_probeManager->deleteLater();
+  m_probeManager = nullptr;
+}
+
+void NetworkManager::increaseNetworkRequestCount(Pool pool) {
+  ++m_stats[pool].m_requests;
+
+  if (pool == ProbePool) {
+    ++m_probeRequestCount;
+    return;
+  }
+
+  ++m_requestCount;
+}
+
+void NetworkManager::decreaseNetworkRequestCount(Pool pool) {
+  if (pool == ProbePool) {
+    Q_ASSERT(m_probeRequestCount > 0);
+    --m_probeRequestCount;
+
+    if (m_probeRequestCount == 0 && m_discardProbeNeeded) {
+      m_discardProbeNeeded = false;
+      discardProbeNetworkAccessManagerInternal();
+    }
+    return;
+  }
 
-void NetworkManager::decreaseNetworkRequestCount() {
   Q_ASSERT(m_requestCount > 0);
   --m_requestCount;
 
@@ -84,3 +155,30 @@ void NetworkManager::decreaseNetworkRequestCount() {
     clearCacheInternal();
   }
 }
+
+QByteArray NetworkManager::sslSession(Pool pool) const {
+  return m_sslSessions[pool];
+}
+
+void NetworkManager::setSslSession(Pool pool, const QByteArray& session) {
+  m_sslSessions[pool] = session;
+}
+
+void NetworkManager::recordConnection(Pool pool, bool handshake,
+                                      uint32_t handshakeMsec) {
+  PoolStats& stats = m_stats[pool];
+
+  if (!handshake) {
+    ++stats.m_reusedConnections;
+    return;
+  }
+
+  ++stats.m_handshakes;
+
+  stats.m_handshakeTotalMsec += handshakeMsec;
+  stats.m_handshakeMaxMsec = qMax(stats.m_handshakeMaxMsec, handshakeMsec);
+}
+
+const NetworkManager::PoolStats& NetworkManager::poolStats(Pool pool) const {
+  return m_stats[pool];
+}
@@ -23,19 +23,63 @@ class NetworkManager : public QObject {
 
   static QByteArray userAgent();
 
+  // The API requests share one manager, so that periodic calls reuse warm
+  // connections. The captive-portal probes use a separate manager that is
+  // thrown away at each detection: clearing its cache does not affect the
+  // API connections.
+  enum Pool {
+    ApiPool,
+    ProbePool,
+  };
+
+  struct PoolStats {
+    uint32_t m_requests = 0;
+    uint32_t m_handshakes = 0;
+    uint32_t m_reusedConnections = 0;
+    uint64_t m_handshakeTotalMsec = 0;
+    uint32_t m_handshakeMaxMsec = 0;
+  };
+
   virtual QNetworkAccessManager* networkAccessManager() = 0;
 
+  QNetworkAccessManager* networkAccessManager(Pool pool);
+
+  // Clears the connections of all the pools.
   void clearCache();
 
-  void increaseNetworkRequestCount();
-  void decreaseNetworkRequestCount();
+  // Replaces the probe manager with a fresh one, once the pending probes are
+  // completed.
+  void discardProbeNetworkAccessManager();
+
+  void increaseNetworkRequestCount(Pool pool);
+  void decreaseNetworkRequestCount(Pool pool);
+
+  // TLS sessions are kept per pool and offered again to the server when a new
+  // connection is opened.
+  QByteArray sslSession(Pool pool) const;
+  void setSslSession(Pool pool, const QByteArray& session);
+
+  // Qt does not tell if a TLS session has been resumed. The handshake time
+  // shows the effect of the resumptions.
+  void recordConnection(Pool pool, bool handshake, uint32_t handshakeMsec);
+  const PoolStats& poolStats(Pool pool) const;
 
  protected:
   virtual void clearCacheInternal() = 0;
 
+ private:
+  void discardProbeNetworkAccessManagerInternal();
+
  private:
   uint32_t m_requestCount = 0;
   bool m_clearCacheNeeded = false;
+
+  QNetworkAccessManager* m_probeManager = nullptr;
+  uint32_t m_probeRequestCount = 0;
+  bool m_discardProbeNeeded = false;
+
+  QByteArray m_sslSessions[ProbePool + 1];
+  PoolStats m_stats[ProbePool + 1];
 };
 
 #endif  // NETWORKMANAGER_H
@@ -8,9 +8,12 @@
 #include "leakdetector.h"
 #include "logger.h"
 #include "networkmanager.h"
+#include "networkrequeststats.h"
+#include "retrypolicy.h"
 #include "settingsholder.h"
 
 #include <QHostAddress>
+#include <QSslConfiguration>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkAccessManager>
@@ -24,9 +27,12 @@ constexpr uint32_t REQUEST_TIMEOUT_MSEC = 15000;
 constexpr const char* IPINFO_URL_IPV4 = "https://%1/api/v1/vpn/ipinfo";
 constexpr const char* IPINFO_URL_IPV6 = "https://[%1]/api/v1/vpn/ipinfo";
 
+// Status code of a conditional request whose cached response is still valid.
+constexpr int HTTP_NOT_MODIFIED = 304;
+
 namespace {
 Logger logger(LOG_NETWORKING, "NetworkRequest");
-}
+}  // namespace
 
 NetworkRequest::NetworkRequest(QObject* parent, int status)
     : QObject(parent), m_status(status) {
@@ -50,9 +56,9 @@ NetworkRequest::NetworkRequest(QObject* parent, int status)
   m_timer.setSingleShot(true);
 
   connect(&m_timer, &QTimer::timeout, this, &NetworkRequest::timeout);
-  connect(&m_timer, &QTimer::timeout, this, &QObject::deleteLater);
 
-  NetworkManager::instance()->increaseNetworkRequestCount();
+  m_retryTimer.setSingleShot(true);
+  connect(&m_retryTimer, &QTimer::timeout, this, &NetworkRequest::sendRequest);
 }
 
 NetworkRequest::~NetworkRequest() {
@@ -60,8 +66,8 @@ NetworkRequest::~NetworkRequest() {
 
   // During the shutdown, the QML NetworkManager can be released before the
   // deletion of the pending network requests.
-  if (NetworkManager::exists()) {
-    NetworkManager::instance()->decreaseNetworkRequestCount();
+  if (m_reply && NetworkManager::exists()) {
+    NetworkManager::instance()->decreaseNetworkRequestCount(m_pool);
   }
 }
 
@@ -72,6 +78,7 @@ NetworkRequest* NetworkRequest::createForGetUrl(QObject* parent,
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, status);
+  r->m_endpoint = "getUrl";
   r->m_request.setHeader(QNetworkRequest::ContentTypeHeader,
                          "application/json");
 
@@ -88,6 +95,7 @@ NetworkRequest* NetworkRequest::createForAuthenticationVerification(
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "authenticationVerification";
   r->m_request.setHeader(QNetworkRequest::ContentTypeHeader,
                          "application/json");
 
@@ -112,6 +120,7 @@ NetworkRequest* NetworkRequest::createForDeviceCreation(
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 201);
+  r->m_endpoint = "deviceCreation";
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -140,6 +149,7 @@ NetworkRequest* NetworkRequest::createForDeviceRemoval(QObject* parent,
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 204);
+  r->m_endpoint = "deviceRemoval";
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -164,6 +174,8 @@ NetworkRequest* NetworkRequest::createForServers(QObject* parent) {
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "servers";
+  r->m_retryPolicy = RetryPolicy::api();
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -173,6 +185,9 @@ NetworkRequest* NetworkRequest::createForServers(QObject* parent) {
   url.setPath("/api/v1/vpn/servers");
   r->m_request.setUrl(url);
 
+  r->enableResponseValidators("servers",
+                              SettingsHolder::instance()->hasServers());
+
   r->getRequest();
   return r;
 }
@@ -181,6 +196,8 @@ NetworkRequest* NetworkRequest::createForSurveyData(QObject* parent) {
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "surveys";
+  r->m_retryPolicy = RetryPolicy::api();
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -190,6 +207,9 @@ NetworkRequest* NetworkRequest::createForSurveyData(QObject* parent) {
   url.setPath("/api/v1/vpn/surveys");
   r->m_request.setUrl(url);
 
+  r->enableResponseValidators("surveys",
+                              SettingsHolder::instance()->hasSurveys());
+
   r->getRequest();
   return r;
 }
@@ -198,6 +218,8 @@ NetworkRequest* NetworkRequest::createForVersions(QObject* parent) {
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "versions";
+  r->m_retryPolicy = RetryPolicy::api();
 
   QUrl url(Constants::API_URL);
   url.setPath("/api/v1/vpn/versions");
@@ -211,6 +233,8 @@ NetworkRequest* NetworkRequest::createForAccount(QObject* parent) {
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "account";
+  r->m_retryPolicy = RetryPolicy::api();
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -220,6 +244,11 @@ NetworkRequest* NetworkRequest::createForAccount(QObject* parent) {
   url.setPath("/api/v1/vpn/account");
   r->m_request.setUrl(url);
 
+  SettingsHolder* settingsHolder = SettingsHolder::instance();
+  r->enableResponseValidators(
+      "account",
+      settingsHolder->hasDevices() && settingsHolder->hasUserEmail());
+
   r->getRequest();
   return r;
 }
@@ -229,6 +258,7 @@ NetworkRequest* NetworkRequest::createForIpInfo(QObject* parent,
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "ipInfo";
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -260,6 +290,8 @@ NetworkRequest* NetworkRequest::createForCaptivePortalDetection(
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 0);
+  r->m_endpoint = "captivePortalDetection";
+  r->m_pool = NetworkManager::ProbePool;
 
   r->m_request.setUrl(url);
   r->m_request.setRawHeader("Host", host);
@@ -270,6 +302,8 @@ NetworkRequest* NetworkRequest::createForCaptivePortalDetection(
 
 NetworkRequest* NetworkRequest::createForCaptivePortalLookup(QObject* parent) {
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "captivePortalLookup";
+  r->m_retryPolicy = RetryPolicy::api();
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -285,6 +319,7 @@ NetworkRequest* NetworkRequest::createForCaptivePortalLookup(QObject* parent) {
 
 NetworkRequest* NetworkRequest::createForHeartbeat(QObject* parent) {
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "heartbeat";
 
   QUrl url(Constants::API_URL);
   url.setPath("/__heartbeat__");
@@ -299,6 +334,7 @@ NetworkRequest* NetworkRequest::createForIOSProducts(QObject* parent) {
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 200);
+  r->m_endpoint = "iosProducts";
 
   QByteArray authorizationHeader = "Bearer ";
   authorizationHeader.append(SettingsHolder::instance()->token().toLocal8Bit());
@@ -317,6 +353,7 @@ NetworkRequest* NetworkRequest::createForIOSPurchase(QObject* parent,
   Q_ASSERT(parent);
 
   NetworkRequest* r = new NetworkRequest(parent, 201);
+  r->m_endpoint = "iosPurchase";
   r->m_request.setHeader(QNetworkRequest::ContentTypeHeader,
                          "application/json");
 
@@ -346,12 +383,17 @@ void NetworkRequest::replyFinished() {
 
   if (m_completed) {
     Q_ASSERT(!m_timer.isActive());
+    deleteLater();
     return;
   }
 
-  m_completed = true;
   m_timer.stop();
 
+  if (m_handshakeMsec < 0 && m_request.url().scheme() == "https" &&
+      m_reply->error() == QNetworkReply::NoError) {
+    NetworkManager::instance()->recordConnection(m_pool, false, 0);
+  }
+
   int status = statusCode();
 
   logger.log() << "Network reply received - status:" << status
@@ -362,10 +404,35 @@ void NetworkRequest::replyFinished() {
   if (m_reply->error() != QNetworkReply::NoError) {
     logger.log() << "Network error:" << m_reply->error()
                  << "status code:" << status << "- body:" << data;
+
+    // A request aborted by its owner (the loser of a race, for instance) is
+    // neither retried nor counted as a failure of the endpoint.
+    if (!m_aborted ||
+        m_reply->error() != QNetworkReply::OperationCanceledError) {
+      if (maybeRetry(m_reply->error(), status, data.length())) {
+        return;
+      }
+
+      recordStats(true, data.length());
+    }
+
+    m_completed = true;
+    deleteLater();
     emit requestFailed(m_reply->error(), data);
     return;
   }
 
+  recordStats(false, data.length());
+
+  m_completed = true;
+  deleteLater();
+
+  if (m_conditional && status == HTTP_NOT_MODIFIED) {
+    logger.log() << "Cached response still valid";
+    emit requestUnchanged();
+    return;
+  }
+
   // This is an extra check for succeeded requests (status code 200 vs 201, for
   // instance). The real network status check is done in the previous if-stmt.
   if (m_status && status != m_status) {
@@ -375,11 +442,59 @@ void NetworkRequest::replyFinished() {
     return;
   }
 
+  if (!m_validatorEndpoint.isEmpty()) {
+    storeResponseValidators();
+  }
+
   emit requestCompleted(data);
 }
 
+void NetworkRequest::enableResponseValidators(const QString& endpoint,
+                                              bool hasCachedResponse) {
+  m_validatorEndpoint = endpoint;
+
+  // A 304 response has no body: without a cached copy of the previous one,
+  // we must ask for the full response.
+  if (!hasCachedResponse) {
+    return;
+  }
+
+  QByteArray eTag;
+  QByteArray lastModified;
+
+  if (!SettingsHolder::instance()->responseValidators(endpoint, eTag,
+                                                      lastModified)) {
+    return;
+  }
+
+  if (!eTag.isEmpty()) {
+    m_request.setRawHeader("If-None-Match", eTag);
+    m_conditional = true;
+  }
+
+  if (!lastModified.isEmpty()) {
+    m_request.setRawHeader("If-Modified-Since", lastModified);
+    m_conditional = true;
+  }
+}
+
+void NetworkRequest::storeResponseValidators() {
+  Q_ASSERT(m_reply);
+
+  QByteArray eTag = m_reply->rawHeader("ETag");
+  QByteArray lastModified = m_reply->rawHeader("Last-Modified");
+
+  SettingsHolder::instance()->setResponseValidators(m_validatorEndpoint, eTag,
+                                                    lastModified);
+}
+
 void NetworkRequest::handleHeaderReceived() {
   logger.log() << "Network header received";
+
+  if (m_firstByteMsec < 0) {
+    m_firstByteMsec = m_elapsedTimer.elapsed();
+  }
+
   emit requestHeaderReceived(this);
 }
 
@@ -388,34 +503,130 @@ void NetworkRequest::timeout() {
   Q_ASSERT(!m_reply->isFinished());
   Q_ASSERT(!m_completed);
 
+  logger.log() << "Network request timeout";
+
+  if (maybeRetry(QNetworkReply::TimeoutError, 0, 0)) {
+    return;
+  }
+
+  recordStats(true, 0);
+
   m_completed = true;
   m_reply->abort();
+  deleteLater();
 
-  logger.log() << "Network request timeout";
   emit requestFailed(QNetworkReply::TimeoutError, QByteArray());
 }
 
 void NetworkRequest::getRequest() {
-  QNetworkAccessManager* manager =
-      NetworkManager::instance()->networkAccessManager();
-  handleReply(manager->get(m_request));
-  m_timer.start(REQUEST_TIMEOUT_MSEC);
+  m_method = Get;
+  sendRequest();
 }
 
 void NetworkRequest::deleteRequest() {
-  QNetworkAccessManager* manager =
-      NetworkManager::instance()->networkAccessManager();
-  handleReply(manager->sendCustomRequest(m_request, "DELETE"));
-  m_timer.start(REQUEST_TIMEOUT_MSEC);
+  m_method = Delete;
+  sendRequest();
 }
 
 void NetworkRequest::postRequest(const QByteArray& body) {
-  QNetworkAccessManager* manager =
-      NetworkManager::instance()->networkAccessManager();
-  handleReply(manager->post(m_request, body));
+  m_method = Post;
+  m_body = body;
+  m_bytesSent = body.length();
+  sendRequest();
+}
+
+void NetworkRequest::sendRequest() {
+  QNetworkAccessManager* manager = prepareRequest();
+
+  switch (m_method) {
+    case Get:
+      handleReply(manager->get(m_request));
+      break;
+    case Delete:
+      handleReply(manager->sendCustomRequest(m_request, "DELETE"));
+      break;
+    case Post:
+      handleReply(manager->post(m_request, m_body));
+      break;
+  }
+
   m_timer.start(REQUEST_TIMEOUT_MSEC);
 }
 
+bool NetworkRequest::maybeRetry(QNetworkReply::NetworkError error,
+                                int status, qint64 bytesReceived) {
+  Q_ASSERT(m_reply);
+
+  if (!m_retryPolicy.canRetry(m_attempts) ||
+      !RetryPolicy::isRetryable(error, status)) {
+    return false;
+  }
+
+  if (!RetryPolicy::consumeBudget()) {
+    logger.log() << "Retry budget exhausted";
+    return false;
+  }
+
+  uint32_t delay = m_retryPolicy.delayMsec(m_attempts);
+
+  bool ok = false;
+  uint32_t retryAfter = m_reply->rawHeader("Retry-After").toUInt(&ok);
+  if (ok) {
+    delay = qMax(delay, qMin(retryAfter * 1000, m_retryPolicy.maxDelayMsec()));
+  }
+
+  logger.log() << "Retrying the request in" << delay << "ms - attempt:"
+               << m_attempts + 1;
+
+  // The failure is recorded only when the retries are over.
+  recordStats(true, bytesReceived, true);
+
+  // The reply of the failed attempt is released.
+  m_timer.stop();
+  m_reply->disconnect(this);
+  if (!m_reply->isFinished()) {
+    m_reply->abort();
+  }
+  m_reply->deleteLater();
+  m_reply = nullptr;
+
+  NetworkManager::instance()->decreaseNetworkRequestCount(m_pool);
+
+  m_handshakeMsec = -1;
+  m_firstByteMsec = -1;
+
+  m_retryTimer.start(delay);
+  return true;
+}
+
+QNetworkAccessManager* NetworkRequest::prepareRequest() {
+  NetworkManager* networkManager = NetworkManager::instance();
+
+#ifndef QT_NO_SSL
+  if (m_request.url().scheme() == "https") {
+    QSslConfiguration config = m_request.sslConfiguration();
+    config.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+
+    QByteArray session = networkManager->sslSession(m_pool);
+    if (!session.isEmpty()) {
+      config.setSessionTicket(session);
+    }
+
+    m_request.setSslConfiguration(config);
+  }
+#endif
+
+  if (m_attempts == 0) {
+    RetryPolicy::requestStarted();
+  }
+  ++m_attempts;
+
+  networkManager->increaseNetworkRequestCount(m_pool);
+  m_elapsedTimer.start();
+
+  return networkManager->networkAccessManager(m_pool);
+}
+
 void NetworkRequest::handleReply(QNetworkReply* reply) {
   Q_ASSERT(reply);
   Q_ASSERT(!m_reply);
@@ -427,7 +638,51 @@ void NetworkRequest::handleReply(QNetworkReply* reply) {
           &NetworkRequest::replyFinished);
   connect(m_reply, &QNetworkReply::metaDataChanged, this,
           &NetworkRequest::handleHeaderReceived);
-  connect(m_reply, &QNetworkReply::finished, this, &QObject::deleteLater);
+
+#ifndef QT_NO_SSL
+  connect(m_reply, &QNetworkReply::encrypted, this,
+          &NetworkRequest::handleEncrypted);
+#endif
+}
+
+#ifndef QT_NO_SSL
+void NetworkRequest::handleEncrypted() {
+  Q_ASSERT(m_reply);
+
+  // Connections reused from the cache do not emit encrypted(). The time
+  // includes the DNS lookup and the TCP connection.
+  m_handshakeMsec = m_elapsedTimer.elapsed();
+
+  logger.log() << "TLS handshake completed in" << m_handshakeMsec << "ms";
+
+  NetworkManager* networkManager = NetworkManager::instance();
+  networkManager->recordConnection(m_pool, true,
+                                   static_cast<uint32_t>(m_handshakeMsec));
+
+  QByteArray session = m_reply->sslConfiguration().sessionTicket();
+  if (!session.isEmpty()) {
+    networkManager->setSslSession(m_pool, session);
+  }
+}
+#endif
+
+void NetworkRequest::recordStats(bool failed, qint64 bytesReceived,
+                                 bool retried) {
+  NetworkRequestStats::Sample sample;
+  sample.m_setupMsec = m_handshakeMsec;
+  sample.m_firstByteMsec = m_firstByteMsec;
+  sample.m_totalMsec = m_elapsedTimer.elapsed();
+  sample.m_bytesSent = m_bytesSent;
+  sample.m_bytesReceived = bytesReceived;
+  sample.m_failed = failed;
+  sample.m_retried = retried;
+
+  logger.log() << "Network request" << m_endpoint
+               << "- total:" << sample.m_totalMsec
+               << "ms - first byte:" << sample.m_firstByteMsec
+               << "ms - received:" << bytesReceived;
+
+  NetworkRequestStats::record(m_endpoint, sample);
 }
 
 int NetworkRequest::statusCode() const {
@@ -455,11 +710,20 @@ QByteArray NetworkRequest::rawHeader(const QByteArray& headerName) const {
 }
 
 void NetworkRequest::abort() {
+  if (m_retryTimer.isActive()) {
+    m_retryTimer.stop();
+    m_completed = true;
+    deleteLater();
+    emit requestFailed(QNetworkReply::OperationCanceledError, QByteArray());
+    return;
+  }
+
   if (!m_reply) {
     logger.log() << "INTERNAL ERROR! NetworkRequest::abort called before "
                     "starting the request";
     return;
   }
 
+  m_aborted = true;
   m_reply->abort();
 }
@@ -5,6 +5,10 @@
 #ifndef NETWORKREQUEST_H
 #define NETWORKREQUEST_H
 
+#include "networkmanager.h"
+#include "retrypolicy.h"
+
+#include <QElapsedTimer>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QObject>
@@ -76,8 +80,31 @@ class NetworkRequest final : public QObject {
   void getRequest();
   void postRequest(const QByteArray& body);
 
+  void sendRequest();
+
+  // Schedules a new attempt if the retry policy allows it. The failure is not
+  // reported to the caller in this case.
+  bool maybeRetry(QNetworkReply::NetworkError error, int status,
+                  qint64 bytesReceived);
+
+  // Returns the manager of the request pool, offering the last TLS session
+  // of the pool to the server.
+  QNetworkAccessManager* prepareRequest();
+
   void handleReply(QNetworkReply* reply);
   void handleHeaderReceived();
+#ifndef QT_NO_SSL
+  void handleEncrypted();
+#endif
+
+  void recordStats(bool failed, qint64 bytesReceived, bool retried = false);
+
+  // Sends If-None-Match/If-Modified-Since headers if validators are known for
+  // this endpoint and the previous response is still cached by the caller.
+  // The validators are stored in the settings.
+  void enableResponseValidators(const QString& endpoint,
+                                bool hasCachedResponse);
+  void storeResponseValidators();
 
  private slots:
   void replyFinished();
@@ -87,14 +114,43 @@ class NetworkRequest final : public QObject {
   void requestHeaderReceived(NetworkRequest* request);
   void requestFailed(QNetworkReply::NetworkError error, const QByteArray& data);
   void requestCompleted(const QByteArray& data);
+  // Emitted instead of requestCompleted when the server answers a conditional
+  // request with 304: the cached response is still valid.
+  void requestUnchanged();
 
  private:
   QNetworkRequest m_request;
   QTimer m_timer;
 
+  enum Method {
+    Get,
+    Delete,
+    Post,
+  };
+
+  Method m_method = Get;
+  QByteArray m_body;
+
+  RetryPolicy m_retryPolicy;
+  QTimer m_retryTimer;
+  int m_attempts = 0;
+
   QNetworkReply* m_reply = nullptr;
   int m_status = 0;
   bool m_completed = false;
+  bool m_aborted = false;
+
+  // Name used to group the request stats.
+  QString m_endpoint;
+
+  NetworkManager::Pool m_pool = NetworkManager::ApiPool;
+  QElapsedTimer m_elapsedTimer;
+  qint64 m_handshakeMsec = -1;
+  qint64 m_firstByteMsec = -1;
+  qint64 m_bytesSent = 0;
+
+  QString m_validatorEndpoint;
+  bool m_conditional = false;
 };
 
 #endif  // NETWORKREQUEST_H
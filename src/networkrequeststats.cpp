@@ -0,0 +1,186 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "networkrequeststats.h"
+#include "networkmanager.h"
+
+#include <QJsonArray>
+#include <QMap>
+#include <QtMath>
+#include <QTextStream>
+
+namespace {
+
+struct EndpointStats {
+  quint64 m_requests = 0;
+  quint64 m_failures = 0;
+  quint64 m_retries = 0;
+  NetworkRequestStats::Histogram m_setup;
+  NetworkRequestStats::Histogram m_firstByte;
+  NetworkRequestStats::Histogram m_total;
+  NetworkRequestStats::Histogram m_bytesSent;
+  NetworkRequestStats::Histogram m_bytesReceived;
+};
+
+// Sorted by endpoint name, for a stable output.
+QMap<QString, EndpointStats> s_endpoints;
+
+QJsonObject poolToJson(const NetworkManager::PoolStats& stats) {
+  QJsonObject obj;
+  obj["requests"] = (double)stats.m_requests;
+  obj["handshakes"] = (double)stats.m_handshakes;
+  obj["reusedConnections"] = (double)stats.m_reusedConnections;
+  obj["averageHandshakeMsec"] =
+      stats.m_handshakes
+          ? (double)stats.m_handshakeTotalMsec / stats.m_handshakes
+          : 0.0;
+  obj["maxHandshakeMsec"] = (double)stats.m_handshakeMaxMsec;
+  return obj;
+}
+
+}  // namespace
+
+void NetworkRequestStats::Histogram::add(quint64 value) {
+  int bucket = 0;
+  while (bucket < BUCKETS - 1 && (value >> bucket) > 0) {
+    ++bucket;
+  }
+
+  ++m_buckets[bucket];
+
+  m_min = m_count ? qMin(m_min, value) : value;
+  m_max = qMax(m_max, value);
+  m_sum += value;
+  ++m_count;
+}
+
+quint64 NetworkRequestStats::Histogram::percentile(double p) const {
+  if (!m_count) {
+    return 0;
+  }
+
+  quint64 rank = qMax<quint64>(1, qCeil(p * m_count));
+  quint64 seen = 0;
+  for (int bucket = 0; bucket < BUCKETS; ++bucket) {
+    seen += m_buckets[bucket];
+    if (seen >= rank) {
+      // The bucket N contains the values in [2^(N-1), 2^N).
+      quint64 upperBound = bucket ? (Q_UINT64_C(1) << bucket) - 1 : 0;
+      return qBound(m_min, upperBound, m_max);
+    }
+  }
+
+  return m_max;
+}
+
+QJsonObject NetworkRequestStats::Histogram::toJson() const {
+  QJsonObject obj;
+  obj["count"] = (double)m_count;
+  obj["min"] = (double)m_min;
+  obj["max"] = (double)m_max;
+  obj["average"] = m_count ? (double)m_sum / m_count : 0.0;
+  obj["p50"] = (double)percentile(0.5);
+  obj["p90"] = (double)percentile(0.9);
+  obj["p99"] = (double)percentile(0.99);
+
+  QJsonArray buckets;
+  for (int bucket = 0; bucket < BUCKETS; ++bucket) {
+    if (m_buckets[bucket]) {
+      QJsonArray pair;
+      pair.append(bucket ? (double)((Q_UINT64_C(1) << bucket) - 1) : 0.0);
+      pair.append((double)m_buckets[bucket]);
+      buckets.append(pair);
+    }
+  }
+  obj["buckets"] = buckets;
+
+  return obj;
+}
+
+// static
+void NetworkRequestStats::record(const QString& endpoint,
+                                 const Sample& sample) {
+  EndpointStats& stats = s_endpoints[endpoint];
+
+  ++stats.m_requests;
+  if (sample.m_retried) {
+    ++stats.m_retries;
+  } else if (sample.m_failed) {
+    ++stats.m_failures;
+  }
+
+  if (sample.m_setupMsec >= 0) {
+    stats.m_setup.add(sample.m_setupMsec);
+  }
+
+  if (sample.m_firstByteMsec >= 0) {
+    stats.m_firstByte.add(sample.m_firstByteMsec);
+  }
+
+  stats.m_total.add(sample.m_totalMsec);
+  stats.m_bytesSent.add(sample.m_bytesSent);
+  stats.m_bytesReceived.add(sample.m_bytesReceived);
+}
+
+// static
+QJsonObject NetworkRequestStats::status() {
+  QJsonObject endpoints;
+  for (auto i = s_endpoints.constBegin(); i != s_endpoints.constEnd(); ++i) {
+    QJsonObject obj;
+    obj["requests"] = (double)i->m_requests;
+    obj["failures"] = (double)i->m_failures;
+    obj["retries"] = (double)i->m_retries;
+    obj["setupMsec"] = i->m_setup.toJson();
+    obj["firstByteMsec"] = i->m_firstByte.toJson();
+    obj["totalMsec"] = i->m_total.toJson();
+    obj["bytesSent"] = i->m_bytesSent.toJson();
+    obj["bytesReceived"] = i->m_bytesReceived.toJson();
+    endpoints[i.key()] = obj;
+  }
+
+  QJsonObject obj;
+  obj["endpoints"] = endpoints;
+
+  if (NetworkManager::exists()) {
+    NetworkManager* nm = NetworkManager::instance();
+
+    QJsonObject pools;
+    pools["api"] = poolToJson(nm->poolStats(NetworkManager::ApiPool));
+    pools["probe"] = poolToJson(nm->poolStats(NetworkManager::ProbePool));
+    obj["pools"] = pools;
+  }
+
+  return obj;
+}
+
+// static
+QString NetworkRequestStats::report() {
+  QString buffer;
+  QTextStream out(&buffer);
+
+  for (auto i = s_endpoints.constBegin(); i != s_endpoints.constEnd(); ++i) {
+    out << i.key() << " -> requests: " << i->m_requests
+        << " - failures: " << i->m_failures << " - retries: " << i->m_retries
+        << Qt::endl;
+
+    auto line = [&out](const char* name, const Histogram& histogram) {
+      out << "  " << name << " -> count: " << histogram.count()
+          << " - p50: " << histogram.percentile(0.5)
+          << " - p90: " << histogram.percentile(0.9)
+          << " - p99: " << histogram.percentile(0.99)
+          << " - max: " << histogram.max() << Qt::endl;
+    };
+
+    line("setupMsec", i->m_setup);
+    line("firstByteMsec", i->m_firstByte);
+    line("totalMsec", i->m_total);
+    line("bytesSent", i->m_bytesSent);
+    line("bytesReceived", i->m_bytesReceived);
+  }
+
+  return buffer;
+}
+
+// static
+void NetworkRequestStats::reset() { s_endpoints.clear(); }
@@ -0,0 +1,61 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef NETWORKREQUESTSTATS_H
+#define NETWORKREQUESTSTATS_H
+
+#include <QJsonObject>
+#include <QString>
+
+// Latency and size of the network requests, grouped by endpoint. The values
+// are stored in histograms with power-of-two buckets: the percentiles are
+// rounded up to the bucket boundary.
+class NetworkRequestStats final {
+ public:
+  class Histogram final {
+   public:
+    static constexpr int BUCKETS = 33;
+
+    void add(quint64 value);
+
+    quint64 count() const { return m_count; }
+    quint64 max() const { return m_max; }
+    quint64 percentile(double p) const;
+
+    QJsonObject toJson() const;
+
+   private:
+    quint64 m_buckets[BUCKETS] = {};
+    quint64 m_count = 0;
+    quint64 m_sum = 0;
+    quint64 m_min = 0;
+    quint64 m_max = 0;
+  };
+
+  struct Sample {
+    // Qt does not expose the DNS and TCP phases: the setup time goes from the
+    // request to the end of the TLS handshake, and it is -1 when the
+    // connection has been reused.
+    qint64 m_setupMsec = -1;
+    qint64 m_firstByteMsec = -1;
+    qint64 m_totalMsec = 0;
+    qint64 m_bytesSent = 0;
+    qint64 m_bytesReceived = 0;
+    bool m_failed = false;
+    // A failed attempt that has been retried. It is not a failure of the
+    // request.
+    bool m_retried = false;
+  };
+
+  static void record(const QString& endpoint, const Sample& sample);
+
+  static QJsonObject status();
+
+  // A text summary for the log file.
+  static QString report();
+
+  static void reset();
+};
+
+#endif  // NETWORKREQUESTSTATS_H
@@ -58,6 +58,10 @@ void NetworkWatcher::initialize() {
 
   connect(m_impl, &NetworkWatcherImpl::unsecuredNetwork, this,
           &NetworkWatcher::unsecuredNetwork);
+  connect(m_impl, &NetworkWatcherImpl::networkChanged, this,
+          &NetworkWatcher::currentNetworkChanged);
+  connect(m_impl, &NetworkWatcherImpl::transportChanged, this,
+          &NetworkWatcher::transportChanged);
 
   m_impl->initialize();
 
@@ -137,6 +141,26 @@ void NetworkWatcher::unsecuredNetwork(const QString& networkName,
 #endif
 }
 
+void NetworkWatcher::currentNetworkChanged(const QString& networkName,
+                                           const QString& networkId) {
+  if (m_currentNetworkId == networkId &&
+      m_currentNetworkName == networkName) {
+    return;
+  }
+
+  logger.log() << "Network changed:" << networkName << "id:" << networkId;
+
+  m_currentNetworkName = networkName;
+  m_currentNetworkId = networkId;
+  emit networkChanged();
+}
+
+void NetworkWatcher::transportChanged(
+    NetworkWatcherImpl::TransportChanges changes) {
+  logger.log() << "Transport changed:" << int(changes);
+  emit networkChanged();
+}
+
 void NetworkWatcher::notificationClicked(SystemTrayHandler::Message message) {
   logger.log() << "Notification clicked";
 
@@ -5,13 +5,12 @@
 #ifndef NETWORKWATCHER_H
 #define NETWORKWATCHER_H
 
+#include "networkwatcherimpl.h"
 #include "systemtrayhandler.h"
 
 #include <QElapsedTimer>
 #include <QMap>
 
-class NetworkWatcherImpl;
-
 // This class watches for network changes to detect unsecured wifi.
 class NetworkWatcher final : public QObject {
   Q_OBJECT
@@ -26,7 +25,18 @@ class NetworkWatcher final : public QObject {
   // public for the inspector.
   void unsecuredNetwork(const QString& networkName, const QString& networkId);
 
+  // The BSSID of the active wifi network, if the platform reports it.
+  const QString& currentNetworkId() const { return m_currentNetworkId; }
+
+ signals:
+  // The active network or the network configuration has changed.
+  void networkChanged();
+
  private:
+  void currentNetworkChanged(const QString& networkName,
+                             const QString& networkId);
+  void transportChanged(NetworkWatcherImpl::TransportChanges changes);
+
   void settingsChanged(bool active);
 
   void notificationClicked(SystemTrayHandler::Message message);
@@ -39,6 +49,9 @@ class NetworkWatcher final : public QObject {
 
   QMap<QString, QElapsedTimer> m_networks;
 
+  QString m_currentNetworkName;
+  QString m_currentNetworkId;
+
   // This is used to connect systemTrayHandler lazily.
   bool m_firstNotification = true;
 };
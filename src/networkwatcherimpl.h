@@ -23,11 +23,29 @@ class NetworkWatcherImpl : public QObject {
 
   bool isActive() const { return m_active; }
 
+  // What changed in the network configuration of the device.
+  enum TransportChange {
+    LinkChanged = 0x01,
+    AddressChanged = 0x02,
+    DefaultRouteChanged = 0x04,
+  };
+  Q_DECLARE_FLAGS(TransportChanges, TransportChange)
+
  signals:
   void unsecuredNetwork(const QString& networkName, const QString& networkId);
 
+  // The active network, secured or not. The ID is empty when unknown.
+  void networkChanged(const QString& networkName, const QString& networkId);
+
+  // Links, addresses or default routes have changed. The VPN interface is
+  // ignored.
+  void transportChanged(NetworkWatcherImpl::TransportChanges changes);
+
  private:
   bool m_active = false;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(NetworkWatcherImpl::TransportChanges)
+Q_DECLARE_METATYPE(NetworkWatcherImpl::TransportChanges)
+
 #endif  // NETWORKWATCHERIMPL_H
@@ -52,6 +52,17 @@ void PingHelper::stop() {
   m_pings.clear();
 }
 
+void PingHelper::sendPingNow() {
+  if (!m_pingTimer.isActive()) {
+    return;
+  }
+
+  nextPing();
+
+  // The next periodic ping is a full period from now.
+  m_pingTimer.start();
+}
+
 void PingHelper::nextPing() {
   logger.log() << "Sending a new ping. Total:" << m_pings.length();
 
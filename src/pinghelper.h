@@ -26,6 +26,9 @@ class PingHelper final : public QObject {
 
   void stop();
 
+  // Sends a ping without waiting for the timer.
+  void sendPingNow();
+
  signals:
   void pingSentAndReceived(qint64 msec);
 
@@ -17,6 +17,8 @@ namespace {
 Logger logger(LOG_LINUX, "DBusService");
 }
 
+static DBusMetatypeRegistrationProxy s_dbusMetatypeProxy;
+
 DBusService::DBusService(QObject* parent) : Daemon(parent) {
   MVPN_COUNT_CTOR(DBusService);
   if (!removeInterfaceIfExists()) {
@@ -72,12 +74,6 @@ QString DBusService::version() {
 bool DBusService::activate(const QString& jsonConfig) {
   logger.log() << "Activate";
 
-  if (!PolkitHelper::instance()->checkAuthorization(
-          "org.mozilla.vpn.activate")) {
-    logger.log() << "Polkit rejected";
-    return false;
-  }
-
   QJsonDocument json = QJsonDocument::fromJson(jsonConfig.toLocal8Bit());
   if (!json.isObject()) {
     logger.log() << "Invalid input";
@@ -92,6 +88,18 @@ bool DBusService::activate(const QString& jsonConfig) {
     return false;
   }
 
+  return activateConfig(config);
+}
+
+bool DBusService::activateConfig(const InterfaceConfig& config) {
+  logger.log() << "Activate config";
+
+  if (!PolkitHelper::instance()->checkAuthorization(
+          "org.mozilla.vpn.activate")) {
+    logger.log() << "Polkit rejected";
+    return false;
+  }
+
   return Daemon::activate(config);
 }
 
@@ -100,26 +108,42 @@ bool DBusService::deactivate(bool emitSignals) {
   return Daemon::deactivate(emitSignals);
 }
 
-QString DBusService::status() { return QString(getStatus()); }
+QString DBusService::status() {
+  return QString(QJsonDocument(getStatus()).toJson(QJsonDocument::Compact));
+}
+
+QJsonObject DBusService::getStatus() {
+  DBusInterfaceStatus status = interfaceStatus();
 
-QByteArray DBusService::getStatus() {
-  logger.log() << "Status request";
   QJsonObject json;
+  json.insert("status", QJsonValue(status.connected));
+  if (status.connected) {
+    json.insert("serverIpv4Gateway", QJsonValue(status.serverIpv4Gateway));
+    json.insert("deviceIpv4Address", QJsonValue(status.deviceIpv4Address));
+    json.insert("txBytes", QJsonValue(double(status.txBytes)));
+    json.insert("rxBytes", QJsonValue(double(status.rxBytes)));
+  }
+
+  return json;
+}
+
+DBusInterfaceStatus DBusService::interfaceStatus() {
+  logger.log() << "Status request";
+
+  DBusInterfaceStatus status;
   if (!wgutils()->interfaceExists()) {
     logger.log() << "Unable to get device";
-    json.insert("status", QJsonValue(false));
-    return QJsonDocument(json).toJson(QJsonDocument::Compact);
+    return status;
   }
-  json.insert("status", QJsonValue(true));
-  json.insert("serverIpv4Gateway",
-              QJsonValue(m_lastConfig.m_serverIpv4Gateway));
-  json.insert("deviceIpv4Address",
-              QJsonValue(m_lastConfig.m_deviceIpv4Address));
-  WireguardUtilsLinux::peerBytes pb = wgutils()->getThroughputForInterface();
-  json.insert("txBytes", QJsonValue(pb.txBytes));
-  json.insert("rxBytes", QJsonValue(pb.rxBytes));
 
-  return QJsonDocument(json).toJson(QJsonDocument::Compact);
+  status.connected = true;
+  status.serverIpv4Gateway = m_lastConfig.m_serverIpv4Gateway;
+  status.deviceIpv4Address = m_lastConfig.m_deviceIpv4Address;
+
+  WireguardUtils::peerBytes pb = wgutils()->getThroughputForInterface();
+  status.txBytes = pb.txBytes;
+  status.rxBytes = pb.rxBytes;
+  return status;
 }
 
 QString DBusService::getLogs() {
@@ -127,6 +151,16 @@ QString DBusService::getLogs() {
   return Daemon::logs();
 }
 
+QVariantMap DBusService::getLogsChunk(const QString& cursor) {
+  logger.log() << "Log chunk request";
+
+  QString nextCursor;
+  QVariantMap chunk;
+  chunk.insert("logs", Daemon::logsChunk(cursor, nextCursor));
+  chunk.insert("cursor", nextCursor);
+  return chunk;
+}
+
 bool DBusService::switchServer(const InterfaceConfig& config) {
   logger.log() << "Switching server";
   return wgutils()->configureInterface(config);
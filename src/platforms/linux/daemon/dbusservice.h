@@ -9,6 +9,7 @@
 #include "iputilslinux.h"
 #include "dnsutilslinux.h"
 #include "wireguardutilslinux.h"
+#include "platforms/linux/dbustypes.h"
 
 class DbusAdaptor;
 
@@ -27,12 +28,15 @@ class DBusService final : public Daemon {
 
  public slots:
   bool activate(const QString& jsonConfig);
+  bool activateConfig(const InterfaceConfig& config);
 
   bool deactivate(bool emitSignals = true) override;
   QString status();
+  DBusInterfaceStatus interfaceStatus();
 
   QString version();
   QString getLogs();
+  QVariantMap getLogsChunk(const QString& cursor);
 
  protected:
   bool supportServerSwitching(const InterfaceConfig& config) const override;
@@ -45,7 +49,7 @@ class DBusService final : public Daemon {
   bool supportDnsUtils() const override { return true; }
   DnsUtils* dnsutils() override;
 
-  QByteArray getStatus() override;
+  QJsonObject getStatus() override;
 
  private:
   bool removeInterfaceIfExists();
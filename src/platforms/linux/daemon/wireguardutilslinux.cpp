@@ -216,8 +216,8 @@ WireguardUtils::peerBytes WireguardUtilsLinux::getThroughputForInterface() {
     rxBytes += peer->rx_bytes;
   }
   wg_free_device(device);
-  pb.rxBytes = double(rxBytes);
-  pb.txBytes = double(txBytes);
+  pb.rxBytes = rxBytes;
+  pb.txBytes = txBytes;
   return pb;
 }
 
@@ -49,32 +49,21 @@ QDBusPendingCallWatcher* DBusClient::version() {
 QDBusPendingCallWatcher* DBusClient::activate(
     const Server& server, const Device* device, const Keys* keys,
     const QList<IPAddressRange>& allowedIPAddressRanges) {
-  QJsonObject json;
-  json.insert("privateKey", QJsonValue(keys->privateKey()));
-  json.insert("deviceIpv4Address", QJsonValue(device->ipv4Address()));
-  json.insert("deviceIpv6Address", QJsonValue(device->ipv6Address()));
-  json.insert("serverIpv4Gateway", QJsonValue(server.ipv4Gateway()));
-  json.insert("serverIpv6Gateway", QJsonValue(server.ipv6Gateway()));
-  json.insert("serverPublicKey", QJsonValue(server.publicKey()));
-  json.insert("serverIpv4AddrIn", QJsonValue(server.ipv4AddrIn()));
-  json.insert("serverIpv6AddrIn", QJsonValue(server.ipv6AddrIn()));
-  json.insert("serverPort", QJsonValue((double)server.choosePort()));
-  json.insert("ipv6Enabled",
-              QJsonValue(SettingsHolder::instance()->ipv6Enabled()));
-
-  QJsonArray allowedIPAddesses;
-  for (const IPAddressRange& i : allowedIPAddressRanges) {
-    QJsonObject range;
-    range.insert("address", QJsonValue(i.ipAddress()));
-    range.insert("range", QJsonValue((double)i.range()));
-    range.insert("isIpv6", QJsonValue(i.type() == IPAddressRange::IPv6));
-    allowedIPAddesses.append(range);
-  };
-  json.insert("allowedIPAddressRanges", allowedIPAddesses);
+  InterfaceConfig config;
+  config.m_privateKey = keys->privateKey();
+  config.m_deviceIpv4Address = device->ipv4Address();
+  config.m_deviceIpv6Address = device->ipv6Address();
+  config.m_serverIpv4Gateway = server.ipv4Gateway();
+  config.m_serverIpv6Gateway = server.ipv6Gateway();
+  config.m_serverPublicKey = server.publicKey();
+  config.m_serverIpv4AddrIn = server.ipv4AddrIn();
+  config.m_serverIpv6AddrIn = server.ipv6AddrIn();
+  config.m_serverPort = server.choosePort();
+  config.m_ipv6Enabled = SettingsHolder::instance()->ipv6Enabled();
+  config.m_allowedIPAddressRanges = allowedIPAddressRanges;
 
   logger.log() << "Activate via DBus";
-  QDBusPendingReply<bool> reply =
-      m_dbus->activate(QJsonDocument(json).toJson(QJsonDocument::Compact));
+  QDBusPendingReply<bool> reply = m_dbus->activateConfig(config);
   QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(reply, this);
   QObject::connect(watcher, &QDBusPendingCallWatcher::finished, watcher,
                    &QDBusPendingCallWatcher::deleteLater);
@@ -92,7 +81,7 @@ QDBusPendingCallWatcher* DBusClient::deactivate() {
 
 QDBusPendingCallWatcher* DBusClient::status() {
   logger.log() << "Status via DBus";
-  QDBusPendingReply<QString> reply = m_dbus->status();
+  QDBusPendingReply<DBusInterfaceStatus> reply = m_dbus->interfaceStatus();
   QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(reply, this);
   QObject::connect(watcher, &QDBusPendingCallWatcher::finished, watcher,
                    &QDBusPendingCallWatcher::deleteLater);
@@ -108,6 +97,15 @@ QDBusPendingCallWatcher* DBusClient::getLogs() {
   return watcher;
 }
 
+QDBusPendingCallWatcher* DBusClient::getLogsChunk(const QString& cursor) {
+  logger.log() << "Get logs chunk via DBus";
+  QDBusPendingReply<QVariantMap> reply = m_dbus->getLogsChunk(cursor);
+  QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(reply, this);
+  QObject::connect(watcher, &QDBusPendingCallWatcher::finished, watcher,
+                   &QDBusPendingCallWatcher::deleteLater);
+  return watcher;
+}
+
 QDBusPendingCallWatcher* DBusClient::cleanupLogs() {
   logger.log() << "Cleanup logs via DBus";
   QDBusPendingReply<QString> reply = m_dbus->cleanupLogs();
@@ -36,6 +36,8 @@ class DBusClient final : public QObject {
 
   QDBusPendingCallWatcher* getLogs();
 
+  QDBusPendingCallWatcher* getLogsChunk(const QString& cursor);
+
   QDBusPendingCallWatcher* cleanupLogs();
 
  signals:
@@ -0,0 +1,138 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef DBUSTYPES_H
+#define DBUSTYPES_H
+
+#include "daemon/interfaceconfig.h"
+
+#include <QtDBus/QtDBus>
+#include <QDBusArgument>
+#include <QList>
+#include <QString>
+
+/* D-Bus metatype for the allowed IP address ranges: a(sub) */
+class DBusAllowedRange {
+ public:
+  DBusAllowedRange() {}
+  DBusAllowedRange(const IPAddressRange& range)
+      : address(range.ipAddress()),
+        range(range.range()),
+        isIpv6(range.type() == IPAddressRange::IPv6) {}
+
+  QString address;
+  uint range = 0;
+  bool isIpv6 = false;
+
+  IPAddressRange toIPAddressRange() const {
+    return IPAddressRange(
+        address, range, isIpv6 ? IPAddressRange::IPv6 : IPAddressRange::IPv4);
+  }
+
+  friend QDBusArgument& operator<<(QDBusArgument& args,
+                                   const DBusAllowedRange& data) {
+    args.beginStructure();
+    args << data.address << data.range << data.isIpv6;
+    args.endStructure();
+    return args;
+  }
+  friend const QDBusArgument& operator>>(const QDBusArgument& args,
+                                         DBusAllowedRange& data) {
+    args.beginStructure();
+    args >> data.address >> data.range >> data.isIpv6;
+    args.endStructure();
+    return args;
+  }
+};
+typedef QList<DBusAllowedRange> DBusAllowedRangeList;
+Q_DECLARE_METATYPE(DBusAllowedRange);
+Q_DECLARE_METATYPE(DBusAllowedRangeList);
+
+/* D-Bus metatype for the activateConfig method: (ssssssssqba(sub)) */
+inline QDBusArgument& operator<<(QDBusArgument& args,
+                                 const InterfaceConfig& config) {
+  DBusAllowedRangeList ranges;
+  for (const IPAddressRange& range : config.m_allowedIPAddressRanges) {
+    ranges.append(DBusAllowedRange(range));
+  }
+
+  args.beginStructure();
+  args << config.m_privateKey << config.m_deviceIpv4Address
+       << config.m_deviceIpv6Address << config.m_serverIpv4Gateway
+       << config.m_serverIpv6Gateway << config.m_serverPublicKey
+       << config.m_serverIpv4AddrIn << config.m_serverIpv6AddrIn
+       << static_cast<quint16>(config.m_serverPort) << config.m_ipv6Enabled
+       << ranges;
+  args.endStructure();
+  return args;
+}
+inline const QDBusArgument& operator>>(const QDBusArgument& args,
+                                       InterfaceConfig& config) {
+  quint16 serverPort = 0;
+  DBusAllowedRangeList ranges;
+
+  args.beginStructure();
+  args >> config.m_privateKey >> config.m_deviceIpv4Address >>
+      config.m_deviceIpv6Address >> config.m_serverIpv4Gateway >>
+      config.m_serverIpv6Gateway >> config.m_serverPublicKey >>
+      config.m_serverIpv4AddrIn >> config.m_serverIpv6AddrIn >> serverPort >>
+      config.m_ipv6Enabled >> ranges;
+  args.endStructure();
+
+  config.m_serverPort = serverPort;
+  config.m_allowedIPAddressRanges.clear();
+  for (const DBusAllowedRange& range : ranges) {
+    config.m_allowedIPAddressRanges.append(range.toIPAddressRange());
+  }
+  return args;
+}
+Q_DECLARE_METATYPE(InterfaceConfig);
+
+/* D-Bus metatype for the interfaceStatus method: (bss(tt)) */
+class DBusInterfaceStatus {
+ public:
+  bool connected = false;
+  QString serverIpv4Gateway;
+  QString deviceIpv4Address;
+  quint64 txBytes = 0;
+  quint64 rxBytes = 0;
+
+  friend QDBusArgument& operator<<(QDBusArgument& args,
+                                   const DBusInterfaceStatus& data) {
+    args.beginStructure();
+    args << data.connected << data.serverIpv4Gateway << data.deviceIpv4Address;
+    args.beginStructure();
+    args << data.txBytes << data.rxBytes;
+    args.endStructure();
+    args.endStructure();
+    return args;
+  }
+  friend const QDBusArgument& operator>>(const QDBusArgument& args,
+                                         DBusInterfaceStatus& data) {
+    args.beginStructure();
+    args >> data.connected >> data.serverIpv4Gateway >> data.deviceIpv4Address;
+    args.beginStructure();
+    args >> data.txBytes >> data.rxBytes;
+    args.endStructure();
+    args.endStructure();
+    return args;
+  }
+};
+Q_DECLARE_METATYPE(DBusInterfaceStatus);
+
+class DBusMetatypeRegistrationProxy {
+ public:
+  DBusMetatypeRegistrationProxy() {
+    qRegisterMetaType<DBusAllowedRange>();
+    qDBusRegisterMetaType<DBusAllowedRange>();
+    qRegisterMetaType<DBusAllowedRangeList>();
+    qDBusRegisterMetaType<DBusAllowedRangeList>();
+    qRegisterMetaType<InterfaceConfig>();
+    qDBusRegisterMetaType<InterfaceConfig>();
+    qRegisterMetaType<DBusInterfaceStatus>();
+    qDBusRegisterMetaType<DBusInterfaceStatus>();
+  }
+};
+
+#endif  // DBUSTYPES_H
@@ -13,10 +13,8 @@
 #include "models/server.h"
 #include "mozillavpn.h"
 
+#include <QDBusError>
 #include <QDBusPendingCallWatcher>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonValue>
 #include <QProcess>
 #include <QString>
 
@@ -45,25 +43,17 @@ void LinuxController::initialize(const Device* device, const Keys* keys) {
 }
 
 void LinuxController::initializeCompleted(QDBusPendingCallWatcher* call) {
-  QDBusPendingReply<QString> reply = *call;
+  QDBusPendingReply<DBusInterfaceStatus> reply = *call;
   if (reply.isError()) {
     logger.log() << "Error received from the DBus service";
     emit initialized(false, false, QDateTime());
     return;
   }
 
-  QString status = reply.argumentAt<0>();
-  logger.log() << "Status:" << status;
+  DBusInterfaceStatus status = reply.argumentAt<0>();
+  logger.log() << "Status:" << status.connected;
 
-  QJsonDocument json = QJsonDocument::fromJson(status.toLocal8Bit());
-  Q_ASSERT(json.isObject());
-
-  QJsonObject obj = json.object();
-  Q_ASSERT(obj.contains("status"));
-  QJsonValue statusValue = obj.value("status");
-  Q_ASSERT(statusValue.isBool());
-
-  emit initialized(true, statusValue.toBool(), QDateTime::currentDateTime());
+  emit initialized(true, status.connected, QDateTime::currentDateTime());
 }
 
 void LinuxController::activate(
@@ -122,46 +112,20 @@ void LinuxController::checkStatus() {
 }
 
 void LinuxController::checkStatusCompleted(QDBusPendingCallWatcher* call) {
-  QDBusPendingReply<QString> reply = *call;
+  QDBusPendingReply<DBusInterfaceStatus> reply = *call;
   if (reply.isError()) {
     logger.log() << "Error received from the DBus service";
     return;
   }
 
-  QString status = reply.argumentAt<0>();
-  logger.log() << "Status:" << status;
-
-  QJsonDocument json = QJsonDocument::fromJson(status.toLocal8Bit());
-  Q_ASSERT(json.isObject());
-
-  QJsonObject obj = json.object();
-  Q_ASSERT(obj.contains("status"));
-  QJsonValue statusValue = obj.value("status");
-  Q_ASSERT(statusValue.isBool());
-
-  if (!statusValue.toBool()) {
+  DBusInterfaceStatus status = reply.argumentAt<0>();
+  if (!status.connected) {
     logger.log() << "Unable to retrieve the status from the interface.";
     return;
   }
 
-  Q_ASSERT(obj.contains("serverIpv4Gateway"));
-  QJsonValue serverIpv4Gateway = obj.value("serverIpv4Gateway");
-  Q_ASSERT(serverIpv4Gateway.isString());
-
-  Q_ASSERT(obj.contains("deviceIpv4Address"));
-  QJsonValue deviceIpv4Address = obj.value("deviceIpv4Address");
-  Q_ASSERT(deviceIpv4Address.isString());
-
-  Q_ASSERT(obj.contains("txBytes"));
-  QJsonValue txBytes = obj.value("txBytes");
-  Q_ASSERT(txBytes.isDouble());
-
-  Q_ASSERT(obj.contains("rxBytes"));
-  QJsonValue rxBytes = obj.value("rxBytes");
-  Q_ASSERT(rxBytes.isDouble());
-
-  emit statusUpdated(serverIpv4Gateway.toString(), deviceIpv4Address.toString(),
-                     txBytes.toDouble(), rxBytes.toDouble());
+  emit statusUpdated(status.serverIpv4Gateway, status.deviceIpv4Address,
+                     status.txBytes, status.rxBytes);
 }
 
 void LinuxController::getBackendLogs(
@@ -174,4 +138,41 @@ void LinuxController::getBackendLogs(
           &BackendLogsObserver::completed);
 }
 
+void LinuxController::getBackendLogsChunk(
+    const QString& cursor,
+    std::function<void(const QString&, const QString&)>&& a_callback) {
+  std::function<void(const QString&, const QString&)> callback =
+      std::move(a_callback);
+
+  QDBusPendingCallWatcher* watcher = m_dbus->getLogsChunk(cursor);
+  connect(watcher, &QDBusPendingCallWatcher::finished, this,
+          [this, callback = std::move(callback)](
+              QDBusPendingCallWatcher* call) mutable {
+            QDBusPendingReply<QVariantMap> reply = *call;
+            if (reply.isError() &&
+                reply.error().type() == QDBusError::UnknownMethod) {
+              // A daemon started before the upgrade does not know
+              // getLogsChunk: fetch its logs in a single call.
+              logger.log() << "Chunked logs not supported by the daemon";
+              getBackendLogs([callback = std::move(callback)](
+                                 const QString& logs) {
+                callback(logs, QString());
+              });
+              return;
+            }
+
+            if (reply.isError()) {
+              logger.log() << "Error received from the DBus service";
+              callback(
+                  "Failed to retrieve logs from the mozillavpn linuxdaemon.",
+                  QString());
+              return;
+            }
+
+            QVariantMap chunk = reply.argumentAt<0>();
+            callback(chunk.value("logs").toString(),
+                     chunk.value("cursor").toString());
+          });
+}
+
 void LinuxController::cleanupBackendLogs() { m_dbus->cleanupLogs(); }
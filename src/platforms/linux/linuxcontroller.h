@@ -31,6 +31,10 @@ class LinuxController final : public ControllerImpl {
 
   void getBackendLogs(std::function<void(const QString&)>&& callback) override;
 
+  void getBackendLogsChunk(
+      const QString& cursor,
+      std::function<void(const QString&, const QString&)>&& callback) override;
+
   void cleanupBackendLogs() override;
 
  private slots:
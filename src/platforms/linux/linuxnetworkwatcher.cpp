@@ -41,6 +41,13 @@ void LinuxNetworkWatcher::initialize() {
   connect(m_worker, &LinuxNetworkWatcherWorker::unsecuredNetwork, this,
           &LinuxNetworkWatcher::unsecuredNetwork);
 
+  connect(m_worker, &LinuxNetworkWatcherWorker::networkChanged, this,
+          &LinuxNetworkWatcher::networkChanged);
+
+  qRegisterMetaType<NetworkWatcherImpl::TransportChanges>();
+  connect(m_worker, &LinuxNetworkWatcherWorker::transportChanged, this,
+          &LinuxNetworkWatcher::transportChanged);
+
   emit initializeInThread();
 }
 
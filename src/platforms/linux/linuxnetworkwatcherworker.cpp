@@ -3,11 +3,21 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "linuxnetworkwatcherworker.h"
+#include "daemon/wireguardutils.h"
 #include "leakdetector.h"
 #include "logger.h"
 #include "timersingleshot.h"
 
 #include <QtDBus/QtDBus>
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <unistd.h>
 
 // https://developer.gnome.org/NetworkManager/stable/nm-dbus-types.html#NMDeviceType
 #ifndef NM_DEVICE_TYPE_WIFI
@@ -31,6 +41,19 @@
 #endif
 
 constexpr const char* DBUS_NETWORKMANAGER = "org.freedesktop.NetworkManager";
+constexpr const char* DBUS_NM_DEVICE = "org.freedesktop.NetworkManager.Device";
+constexpr const char* DBUS_NM_DEVICE_WIRELESS =
+    "org.freedesktop.NetworkManager.Device.Wireless";
+constexpr const char* DBUS_NM_ACCESS_POINT =
+    "org.freedesktop.NetworkManager.AccessPoint";
+constexpr const char* DBUS_PROPERTIES = "org.freedesktop.DBus.Properties";
+
+// The access point properties checked by checkDevices().
+const QStringList ACCESS_POINT_RELEVANT_PROPERTIES{"Ssid", "HwAddress",
+                                                   "RsnFlags", "WpaFlags"};
+
+// How long we wait for the end of a burst of netlink messages.
+constexpr uint32_t NETLINK_COALESCE_MSEC = 200;
 
 namespace {
 Logger logger(LOG_LINUX, "LinuxNetworkWatcherWorker");
@@ -49,11 +72,19 @@ LinuxNetworkWatcherWorker::LinuxNetworkWatcherWorker(QThread* thread) {
 
 LinuxNetworkWatcherWorker::~LinuxNetworkWatcherWorker() {
   MVPN_COUNT_DTOR(LinuxNetworkWatcherWorker);
+
+  if (m_netlinkSocket >= 0) {
+    close(m_netlinkSocket);
+  }
 }
 
 void LinuxNetworkWatcherWorker::initialize() {
   logger.log() << "initialize";
 
+  // The netlink changes are needed as soon as possible: they are used to
+  // recover the VPN connection after a network change.
+  initializeNetlink();
+
   // Let's wait a few seconds to allow the UI to be fully loaded and shown.
   // This is not strictly needed, but it's better for user experience because
   // it makes the UI faster to appear, plus it gives a bit of delay between the
@@ -66,96 +97,417 @@ void LinuxNetworkWatcherWorker::initialize() {
     // documentation:
     // https://developer.gnome.org/NetworkManager/stable/gdbus-org.freedesktop.NetworkManager.html
 
-    QDBusInterface nm(DBUS_NETWORKMANAGER, "/org/freedesktop/NetworkManager",
-                      DBUS_NETWORKMANAGER, QDBusConnection::systemBus());
-    if (!nm.isValid()) {
-      logger.log()
-          << "Failed to connect to the network manager via system dbus";
-      return;
-    }
+    QDBusMessage msg = QDBusMessage::createMethodCall(
+        DBUS_NETWORKMANAGER, "/org/freedesktop/NetworkManager",
+        DBUS_NETWORKMANAGER, "GetDevices");
+    QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(
+        QDBusConnection::systemBus().asyncCall(msg), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this,
+            &LinuxNetworkWatcherWorker::devicesReceived);
+  });
+}
 
-    QDBusMessage msg = nm.call("GetDevices");
-    QDBusArgument arg = msg.arguments().at(0).value<QDBusArgument>();
-    if (arg.currentType() != QDBusArgument::ArrayType) {
-      logger.log() << "Expected an array of devices";
-      return;
-    }
+void LinuxNetworkWatcherWorker::devicesReceived(
+    QDBusPendingCallWatcher* call) {
+  call->deleteLater();
+
+  QDBusPendingReply<> reply = *call;
+  if (reply.isError()) {
+    logger.log() << "Failed to connect to the network manager via system dbus";
+    return;
+  }
 
-    QList<QDBusObjectPath> paths = qdbus_cast<QList<QDBusObjectPath> >(arg);
-    for (const QDBusObjectPath& path : paths) {
-      QString devicePath = path.path();
-      QDBusInterface device(DBUS_NETWORKMANAGER, devicePath,
-                            "org.freedesktop.NetworkManager.Device",
-                            QDBusConnection::systemBus());
-      if (device.property("DeviceType").toInt() != NM_DEVICE_TYPE_WIFI) {
-        continue;
+  QDBusArgument arg = reply.reply().arguments().at(0).value<QDBusArgument>();
+  if (arg.currentType() != QDBusArgument::ArrayType) {
+    logger.log() << "Expected an array of devices";
+    return;
+  }
+
+  QList<QDBusObjectPath> paths = qdbus_cast<QList<QDBusObjectPath> >(arg);
+  for (const QDBusObjectPath& path : paths) {
+    QString devicePath = path.path();
+    fetchProperties(devicePath, DBUS_NM_DEVICE, [this, devicePath]() {
+      if (m_properties[devicePath].value("DeviceType").toInt() !=
+          NM_DEVICE_TYPE_WIFI) {
+        m_properties.remove(devicePath);
+        return;
       }
 
       logger.log() << "Found a wifi device:" << devicePath;
       m_devicePaths.append(devicePath);
 
-      // Here we monitor the changes.
+      // Here we monitor the changes. The payload keeps the cache updated.
       QDBusConnection::systemBus().connect(
-          DBUS_NETWORKMANAGER, devicePath, "org.freedesktop.DBus.Properties",
-          "PropertiesChanged", this,
-          SLOT(propertyChanged(QString, QVariantMap, QStringList)));
-    }
+          DBUS_NETWORKMANAGER, devicePath, DBUS_PROPERTIES, "PropertiesChanged",
+          this,
+          SLOT(propertyChanged(QString, QVariantMap, QStringList,
+                               QDBusMessage)));
 
-    if (m_devicePaths.isEmpty()) {
-      logger.log() << "No wifi devices found";
-      return;
-    }
+      // We could be already be activated.
+      fetchProperties(devicePath, DBUS_NM_DEVICE_WIRELESS,
+                      [this, devicePath]() {
+                        accessPointChanged(devicePath, QString());
+                      });
+    });
+  }
+}
 
-    // We could be already be activated.
-    checkDevices();
-  });
+void LinuxNetworkWatcherWorker::fetchProperties(
+    const QString& path, const QString& interface,
+    std::function<void()>&& a_callback) {
+  std::function<void()> callback = std::move(a_callback);
+
+  QDBusMessage msg = QDBusMessage::createMethodCall(
+      DBUS_NETWORKMANAGER, path, DBUS_PROPERTIES, "GetAll");
+  msg << interface;
+
+  QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(
+      QDBusConnection::systemBus().asyncCall(msg), this);
+  connect(watcher, &QDBusPendingCallWatcher::finished, this,
+          [this, path, interface,
+           callback = std::move(callback)](QDBusPendingCallWatcher* call) {
+            call->deleteLater();
+
+            QDBusPendingReply<QVariantMap> reply = *call;
+            if (reply.isError()) {
+              logger.log() << "Failed to read the properties of" << interface
+                           << "for" << path;
+              return;
+            }
+
+            QVariantMap& properties = m_properties[path];
+            const QVariantMap values = reply.value();
+            for (auto i = values.constBegin(); i != values.constEnd(); ++i) {
+              properties.insert(i.key(), i.value());
+            }
+
+            callback();
+          });
 }
 
 void LinuxNetworkWatcherWorker::propertyChanged(QString interface,
                                                 QVariantMap properties,
-                                                QStringList list) {
+                                                QStringList list,
+                                                QDBusMessage message) {
   Q_UNUSED(list);
 
+  QString devicePath = message.path();
+
+  // The active access points are monitored too: their security flags can
+  // change while they stay active. NetworkManager updates Strength and
+  // LastSeen at each scan: these changes are cached silently.
+  if (!m_devicePaths.contains(devicePath)) {
+    auto ap = m_properties.find(devicePath);
+    if (ap == m_properties.end()) {
+      return;
+    }
+
+    bool relevant = false;
+    for (auto i = properties.constBegin(); i != properties.constEnd(); ++i) {
+      ap->insert(i.key(), i.value());
+      relevant |= ACCESS_POINT_RELEVANT_PROPERTIES.contains(i.key());
+    }
+
+    if (relevant) {
+      logger.log() << "Access point properties changed";
+      checkDevices();
+    }
+    return;
+  }
+
   logger.log() << "Properties changed for interface" << interface;
 
+  QString previousAccessPointPath = activeAccessPointPath(devicePath);
+
+  QVariantMap& cache = m_properties[devicePath];
+  for (auto i = properties.constBegin(); i != properties.constEnd(); ++i) {
+    cache.insert(i.key(), i.value());
+  }
+
   if (!properties.contains("ActiveAccessPoint")) {
     logger.log() << "Access point did not changed. Ignoring the changes";
     return;
   }
 
-  checkDevices();
+  accessPointChanged(devicePath, previousAccessPointPath);
+}
+
+QString LinuxNetworkWatcherWorker::activeAccessPointPath(
+    const QString& devicePath) const {
+  QString path = m_properties.value(devicePath)
+                     .value("ActiveAccessPoint")
+                     .value<QDBusObjectPath>()
+                     .path();
+
+  // NetworkManager reports "no access point" as the "/" object path.
+  if (path == "/") {
+    return QString();
+  }
+
+  return path;
+}
+
+void LinuxNetworkWatcherWorker::accessPointChanged(
+    const QString& devicePath, const QString& previousAccessPointPath) {
+  QString accessPointPath = activeAccessPointPath(devicePath);
+  if (accessPointPath == previousAccessPointPath) {
+    return;
+  }
+
+  // The access points come and go. We keep only the active ones.
+  if (!previousAccessPointPath.isEmpty()) {
+    QDBusConnection::systemBus().disconnect(
+        DBUS_NETWORKMANAGER, previousAccessPointPath, DBUS_PROPERTIES,
+        "PropertiesChanged", this,
+        SLOT(propertyChanged(QString, QVariantMap, QStringList,
+                             QDBusMessage)));
+    m_properties.remove(previousAccessPointPath);
+  }
+
+  if (accessPointPath.isEmpty()) {
+    checkDevices();
+    return;
+  }
+
+  QDBusConnection::systemBus().connect(
+      DBUS_NETWORKMANAGER, accessPointPath, DBUS_PROPERTIES,
+      "PropertiesChanged", this,
+      SLOT(propertyChanged(QString, QVariantMap, QStringList, QDBusMessage)));
+
+  fetchProperties(accessPointPath, DBUS_NM_ACCESS_POINT,
+                  [this, devicePath, accessPointPath]() {
+                    // The access point could be gone in the meantime.
+                    if (activeAccessPointPath(devicePath) != accessPointPath) {
+                      m_properties.remove(accessPointPath);
+                      return;
+                    }
+
+                    checkDevices();
+                  });
 }
 
 void LinuxNetworkWatcherWorker::checkDevices() {
   logger.log() << "Checking devices";
 
-  for (const QString& devicePath : m_devicePaths) {
-    QDBusInterface wifiDevice(DBUS_NETWORKMANAGER, devicePath,
-                              "org.freedesktop.NetworkManager.Device.Wireless",
-                              QDBusConnection::systemBus());
+  bool networkFound = false;
 
+  for (const QString& devicePath : m_devicePaths) {
     // Check the access point path
-    QString accessPointPath = wifiDevice.property("ActiveAccessPoint")
-                                  .value<QDBusObjectPath>()
-                                  .path();
+    QString accessPointPath = activeAccessPointPath(devicePath);
     if (accessPointPath.isEmpty()) {
       logger.log() << "No access point found";
       continue;
     }
 
-    QDBusInterface ap(DBUS_NETWORKMANAGER, accessPointPath,
-                      "org.freedesktop.NetworkManager.AccessPoint",
-                      QDBusConnection::systemBus());
+    // The access point properties are still being fetched. We will be called
+    // again when they are available.
+    if (!m_properties.contains(accessPointPath)) {
+      continue;
+    }
+
+    const QVariantMap& ap = m_properties[accessPointPath];
 
-    if (checkUnsecureFlags(ap.property("RsnFlags").toInt()) ||
-        checkUnsecureFlags(ap.property("WpaFlags").toInt())) {
-      QString ssid = ap.property("Ssid").toString();
-      QString bssid = ap.property("HwAddress").toString();
+    QString ssid = ap.value("Ssid").toString();
+    QString bssid = ap.value("HwAddress").toString();
+
+    // The first active access point is the current network.
+    if (!networkFound) {
+      networkFound = true;
+      emit networkChanged(ssid, bssid);
+    }
 
+    if (checkUnsecureFlags(ap.value("RsnFlags").toInt()) ||
+        checkUnsecureFlags(ap.value("WpaFlags").toInt())) {
       // We have found 1 unsecured network. We don't need to check other wifi
       // network devices.
       emit unsecuredNetwork(ssid, bssid);
       break;
     }
   }
+
+  if (!networkFound) {
+    emit networkChanged(QString(), QString());
+  }
+}
+
+void LinuxNetworkWatcherWorker::initializeNetlink() {
+  m_netlinkSocket = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           NETLINK_ROUTE);
+  if (m_netlinkSocket < 0) {
+    logger.log() << "Failed to create netlink socket:" << strerror(errno);
+    return;
+  }
+
+  struct sockaddr_nl nladdr;
+  memset(&nladdr, 0, sizeof(nladdr));
+  nladdr.nl_family = AF_NETLINK;
+  nladdr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV4_ROUTE;
+  if (bind(m_netlinkSocket, (struct sockaddr*)&nladdr, sizeof(nladdr)) != 0) {
+    logger.log() << "Failed to bind netlink socket:" << strerror(errno);
+    close(m_netlinkSocket);
+    m_netlinkSocket = -1;
+    return;
+  }
+
+  m_netlinkNotifier =
+      new QSocketNotifier(m_netlinkSocket, QSocketNotifier::Read, this);
+  connect(m_netlinkNotifier,
+          SIGNAL(activated(QSocketDescriptor, QSocketNotifier::Type)),
+          SLOT(netlinkReady()));
+
+  requestDefaultRoutes();
+}
+
+void LinuxNetworkWatcherWorker::requestDefaultRoutes() {
+  struct {
+    struct nlmsghdr nlmsg;
+    struct rtmsg rtm;
+  } request;
+  memset(&request, 0, sizeof(request));
+
+  m_dumpSeq = 1;
+
+  request.nlmsg.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+  request.nlmsg.nlmsg_type = RTM_GETROUTE;
+  request.nlmsg.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  request.nlmsg.nlmsg_seq = m_dumpSeq;
+  request.rtm.rtm_family = AF_INET;
+
+  if (send(m_netlinkSocket, &request, request.nlmsg.nlmsg_len, 0) < 0) {
+    logger.log() << "Failed to dump the routes:" << strerror(errno);
+  }
+}
+
+int LinuxNetworkWatcherWorker::routeInterfaceIndex(
+    struct nlmsghdr* nlmsg) const {
+  struct rtmsg* rtm = (struct rtmsg*)NLMSG_DATA(nlmsg);
+  int len = RTM_PAYLOAD(nlmsg);
+  for (struct rtattr* attr = RTM_RTA(rtm); RTA_OK(attr, len);
+       attr = RTA_NEXT(attr, len)) {
+    if (attr->rta_type == RTA_OIF) {
+      return *(int*)RTA_DATA(attr);
+    }
+  }
+
+  return 0;
+}
+
+void LinuxNetworkWatcherWorker::netlinkReady() {
+  // The VPN interface changes are caused by the VPN itself. The index changes
+  // at each activation.
+  int vpnIndex = if_nametoindex(WG_INTERFACE);
+
+  char buf[8192];
+  for (;;) {
+    ssize_t len = recv(m_netlinkSocket, buf, sizeof(buf), 0);
+    if (len < 0 && errno == ENOBUFS) {
+      // We have lost some messages. Let's assume that everything changed.
+      logger.log() << "Netlink buffer overrun";
+      addTransportChanges(NetworkWatcherImpl::LinkChanged |
+                          NetworkWatcherImpl::AddressChanged |
+                          NetworkWatcherImpl::DefaultRouteChanged);
+      continue;
+    }
+    if (len <= 0) {
+      break;
+    }
+
+    NetworkWatcherImpl::TransportChanges changes;
+
+    struct nlmsghdr* nlmsg = (struct nlmsghdr*)buf;
+    for (; NLMSG_OK(nlmsg, len); nlmsg = NLMSG_NEXT(nlmsg, len)) {
+      bool dump = m_dumpSeq && nlmsg->nlmsg_seq == m_dumpSeq;
+
+      switch (nlmsg->nlmsg_type) {
+        case RTM_NEWLINK: {
+          // Wireless events (scans, ...) are RTM_NEWLINK messages too. Only
+          // the up/running transitions matter.
+          struct ifinfomsg* ifi = (struct ifinfomsg*)NLMSG_DATA(nlmsg);
+          if (ifi->ifi_index != vpnIndex &&
+              m_defaultRouteIndexes.contains(ifi->ifi_index) &&
+              (ifi->ifi_change & (IFF_UP | IFF_RUNNING))) {
+            changes |= NetworkWatcherImpl::LinkChanged;
+          }
+          break;
+        }
+
+        case RTM_DELLINK: {
+          struct ifinfomsg* ifi = (struct ifinfomsg*)NLMSG_DATA(nlmsg);
+          if (m_defaultRouteIndexes.remove(ifi->ifi_index)) {
+            changes |= NetworkWatcherImpl::LinkChanged;
+          }
+          break;
+        }
+
+        case RTM_NEWADDR:
+          [[fallthrough]];
+        case RTM_DELADDR: {
+          struct ifaddrmsg* ifa = (struct ifaddrmsg*)NLMSG_DATA(nlmsg);
+          if ((int)ifa->ifa_index != vpnIndex &&
+              m_defaultRouteIndexes.contains(ifa->ifa_index)) {
+            changes |= NetworkWatcherImpl::AddressChanged;
+          }
+          break;
+        }
+
+        case RTM_NEWROUTE:
+          [[fallthrough]];
+        case RTM_DELROUTE: {
+          // The VPN routes are in their own table. Here we care about the
+          // default route of the main table only.
+          struct rtmsg* rtm = (struct rtmsg*)NLMSG_DATA(nlmsg);
+          if (rtm->rtm_table != RT_TABLE_MAIN || rtm->rtm_dst_len != 0) {
+            break;
+          }
+
+          int index = routeInterfaceIndex(nlmsg);
+          if (index == 0 || index == vpnIndex) {
+            break;
+          }
+
+          if (nlmsg->nlmsg_type == RTM_NEWROUTE) {
+            m_defaultRouteIndexes.insert(index);
+          } else {
+            m_defaultRouteIndexes.remove(index);
+          }
+
+          if (!dump) {
+            changes |= NetworkWatcherImpl::DefaultRouteChanged;
+          }
+          break;
+        }
+
+        case NLMSG_DONE:
+          if (dump) {
+            logger.log() << "Default route interfaces:"
+                         << m_defaultRouteIndexes.size();
+            m_dumpSeq = 0;
+          }
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    if (changes) {
+      addTransportChanges(changes);
+    }
+  }
+}
+
+void LinuxNetworkWatcherWorker::addTransportChanges(
+    NetworkWatcherImpl::TransportChanges changes) {
+  bool scheduled = m_pendingChanges;
+  m_pendingChanges |= changes;
+  if (scheduled) {
+    return;
+  }
+
+  TimerSingleShot::create(this, NETLINK_COALESCE_MSEC, [this]() {
+    NetworkWatcherImpl::TransportChanges changes = m_pendingChanges;
+    logger.log() << "Transport changed:" << int(changes);
+    m_pendingChanges = NetworkWatcherImpl::TransportChanges();
+    emit transportChanged(changes);
+  });
 }
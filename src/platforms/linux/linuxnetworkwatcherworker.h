@@ -5,12 +5,22 @@
 #ifndef LINUXNETWORKWATCHERWORKER_H
 #define LINUXNETWORKWATCHERWORKER_H
 
-#include <QMap>
+#include "networkwatcherimpl.h"
+
+#include <functional>
+
+#include <QDBusMessage>
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QVariant>
 
+class QDBusPendingCallWatcher;
+class QSocketNotifier;
 class QThread;
 
+struct nlmsghdr;
+
 class LinuxNetworkWatcherWorker final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(LinuxNetworkWatcherWorker)
@@ -25,16 +35,59 @@ class LinuxNetworkWatcherWorker final : public QObject {
 
  signals:
   void unsecuredNetwork(const QString& networkName, const QString& networkId);
+  void networkChanged(const QString& networkName, const QString& networkId);
+  void transportChanged(NetworkWatcherImpl::TransportChanges changes);
 
  private slots:
   void propertyChanged(QString interface, QVariantMap properties,
-                       QStringList list);
+                       QStringList list, QDBusMessage message);
+  void netlinkReady();
+
+ private:
+  void devicesReceived(QDBusPendingCallWatcher* call);
+
+  // Reads all the properties of a DBus interface with one async GetAll.
+  void fetchProperties(const QString& path, const QString& interface,
+                       std::function<void()>&& callback);
+
+  QString activeAccessPointPath(const QString& devicePath) const;
+  void accessPointChanged(const QString& devicePath,
+                          const QString& previousAccessPointPath);
+
+  void initializeNetlink();
+  void requestDefaultRoutes();
+  int routeInterfaceIndex(struct nlmsghdr* nlmsg) const;
+  void addTransportChanges(NetworkWatcherImpl::TransportChanges changes);
 
  private:
   // We collect the list of DBus wifi network device paths during the
   // initialization. When a property of them changes, we check if the access
   // point is active and unsecure.
   QStringList m_devicePaths;
+
+  // The properties of the devices and of their active access points, by DBus
+  // object path. They are fetched once and then updated by the
+  // PropertiesChanged signals of both: checkDevices() does not block on DBus.
+  QHash<QString, QVariantMap> m_properties;
+
+  // Link, address and route changes from rtnetlink. The changes are
+  // coalesced, because a roaming produces a burst of messages.
+  int m_netlinkSocket = -1;
+  QSocketNotifier* m_netlinkNotifier = nullptr;
+  NetworkWatcherImpl::TransportChanges m_pendingChanges;
+
+  // The interfaces of the default routes of the main table. Only their link
+  // and address changes are relevant: the others (docker bridges, other VPNs,
+  // ...) do not carry our tunnel.
+  QSet<int> m_defaultRouteIndexes;
+
+  // The sequence number of the initial route dump. Its replies are not
+  // changes.
+  uint32_t m_dumpSeq = 0;
+
+#ifdef UNIT_TEST
+  friend class TestLinuxNetworkWatcher;
+#endif
 };
 
 #endif  // LINUXNETWORKWATCHERWORKER_H
@@ -9,7 +9,6 @@
 
 #include <QCoreApplication>
 #include <QDir>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QLocalSocket>
@@ -51,7 +50,7 @@ MacOSDaemon* MacOSDaemon::instance() {
   return s_daemon;
 }
 
-QByteArray MacOSDaemon::getStatus() {
+QJsonObject MacOSDaemon::getStatus() {
   logger.log() << "Status request";
 
   QJsonObject obj;
@@ -105,7 +104,7 @@ QByteArray MacOSDaemon::getStatus() {
     obj.insert("rxBytes", QJsonValue(double(rxBytes)));
   }
 
-  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+  return obj;
 }
 
 bool MacOSDaemon::run(Daemon::Op op, const InterfaceConfig& config) {
@@ -14,7 +14,7 @@ class MacOSDaemon final : public Daemon {
 
   static MacOSDaemon* instance();
 
-  QByteArray getStatus() override;
+  QJsonObject getStatus() override;
 
   void maybeCleanup();
 
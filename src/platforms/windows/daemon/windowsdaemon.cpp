@@ -9,7 +9,6 @@
 #include "wgquickprocess.h"
 
 #include <QCoreApplication>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QLocalSocket>
@@ -212,7 +211,7 @@ WindowsDaemon::~WindowsDaemon() {
   stopAndDeleteTunnelService();
 }
 
-QByteArray WindowsDaemon::getStatus() {
+QJsonObject WindowsDaemon::getStatus() {
   logger.log() << "Status request";
 
   QJsonObject obj;
@@ -228,7 +227,7 @@ QByteArray WindowsDaemon::getStatus() {
   });
 
   if (pipe == INVALID_HANDLE_VALUE || !m_connected) {
-    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    return obj;
   }
 
   QByteArray message = "get=1\n\n";
@@ -237,7 +236,7 @@ QByteArray WindowsDaemon::getStatus() {
   if (!WriteFile(pipe, message.constData(), message.length(), &written,
                  nullptr)) {
     WindowsCommons::windowsLog("Failed to write into the pipe");
-    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    return obj;
   }
 
   QByteArray data;
@@ -284,7 +283,7 @@ QByteArray WindowsDaemon::getStatus() {
   obj.insert("txBytes", QJsonValue(double(txBytes)));
   obj.insert("rxBytes", QJsonValue(double(rxBytes)));
 
-  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+  return obj;
 }
 
 bool WindowsDaemon::registerTunnelService(const QString& configFile) {
@@ -17,7 +17,7 @@ class WindowsDaemon final : public Daemon {
   WindowsDaemon();
   ~WindowsDaemon();
 
-  QByteArray getStatus() override;
+  QJsonObject getStatus() override;
 
  private:
   bool run(Op op, const InterfaceConfig& config) override;
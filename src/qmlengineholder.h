@@ -30,11 +30,17 @@ class QmlEngineHolder final : public NetworkManager {
   void showWindow();
   void hideWindow();
 
+  // Msecs from the startup to the first frame of the main window, or -1 if
+  // the window has not been rendered yet.
+  qint64 firstFrameMsec() const { return m_firstFrameMsec; }
+  void setFirstFrameMsec(qint64 msec) { m_firstFrameMsec = msec; }
+
  protected:
   void clearCacheInternal() override;
 
  private:
   QQmlApplicationEngine m_engine;
+  qint64 m_firstFrameMsec = -1;
 };
 
 #endif  // QMLENGINEHOLDER_H
@@ -0,0 +1,100 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "retrypolicy.h"
+#include "errorhandler.h"
+
+#include <QRandomGenerator>
+
+constexpr int API_MAX_ATTEMPTS = 4;
+constexpr uint32_t API_INITIAL_DELAY_MSEC = 1000;
+constexpr uint32_t API_MAX_DELAY_MSEC = 30000;
+
+// Each request earns 1/5 of a retry, up to 10 retries.
+constexpr double RETRY_BUDGET_RATIO = 0.2;
+constexpr double RETRY_BUDGET_MAX = 10;
+
+constexpr int HTTP_TOO_MANY_REQUESTS = 429;
+constexpr int HTTP_BAD_GATEWAY = 502;
+constexpr int HTTP_SERVICE_UNAVAILABLE = 503;
+constexpr int HTTP_GATEWAY_TIMEOUT = 504;
+
+namespace {
+double s_budget = RETRY_BUDGET_MAX;
+}
+
+RetryPolicy::RetryPolicy(int maxAttempts, uint32_t initialDelayMsec,
+                         uint32_t maxDelayMsec)
+    : m_maxAttempts(maxAttempts),
+      m_initialDelayMsec(initialDelayMsec),
+      m_maxDelayMsec(maxDelayMsec) {
+  Q_ASSERT(maxAttempts > 0);
+  Q_ASSERT(initialDelayMsec <= maxDelayMsec);
+}
+
+// static
+RetryPolicy RetryPolicy::api() {
+  return RetryPolicy(API_MAX_ATTEMPTS, API_INITIAL_DELAY_MSEC,
+                     API_MAX_DELAY_MSEC);
+}
+
+uint32_t RetryPolicy::delayMsec(int attempts) const {
+  Q_ASSERT(attempts > 0);
+
+  uint64_t delay = m_initialDelayMsec;
+  for (int i = 1; i < attempts && delay < m_maxDelayMsec; ++i) {
+    delay *= 2;
+  }
+  delay = qMin<uint64_t>(delay, m_maxDelayMsec);
+
+  uint32_t half = delay / 2;
+  return half + QRandomGenerator::global()->bounded(
+                    static_cast<quint32>(delay - half + 1));
+}
+
+// static
+bool RetryPolicy::isRetryable(QNetworkReply::NetworkError error,
+                              int statusCode) {
+  switch (statusCode) {
+    case HTTP_TOO_MANY_REQUESTS:
+      [[fallthrough]];
+    case HTTP_BAD_GATEWAY:
+      [[fallthrough]];
+    case HTTP_SERVICE_UNAVAILABLE:
+      [[fallthrough]];
+    case HTTP_GATEWAY_TIMEOUT:
+      return true;
+    default:
+      break;
+  }
+
+  switch (ErrorHandler::toErrorType(error)) {
+    case ErrorHandler::ConnectionFailureError:
+      [[fallthrough]];
+    case ErrorHandler::NoConnectionError:
+      [[fallthrough]];
+    case ErrorHandler::VPNDependentConnectionError:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+void RetryPolicy::requestStarted() {
+  s_budget = qMin(s_budget + RETRY_BUDGET_RATIO, RETRY_BUDGET_MAX);
+}
+
+// static
+bool RetryPolicy::consumeBudget() {
+  if (s_budget < 1) {
+    return false;
+  }
+
+  s_budget -= 1;
+  return true;
+}
+
+// static
+void RetryPolicy::resetBudget() { s_budget = RETRY_BUDGET_MAX; }
@@ -0,0 +1,48 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef RETRYPOLICY_H
+#define RETRYPOLICY_H
+
+#include <QNetworkReply>
+
+// Capped exponential backoff with jitter. The delay before the retry N is
+// randomly chosen between half and all of min(initialDelay * 2^N, maxDelay),
+// so that the clients hit by the same outage do not retry in sync.
+//
+// The retries of all the network requests share a budget: each new request
+// earns a fraction of a retry, and the budget has a cap. During a long outage
+// the retries stop growing with the number of failing requests.
+class RetryPolicy final {
+ public:
+  // The default policy does not retry.
+  RetryPolicy() = default;
+  RetryPolicy(int maxAttempts, uint32_t initialDelayMsec,
+              uint32_t maxDelayMsec);
+
+  // For the idempotent API requests.
+  static RetryPolicy api();
+
+  bool enabled() const { return m_maxAttempts > 1; }
+
+  // "attempts" is the number of attempts already done.
+  bool canRetry(int attempts) const { return attempts < m_maxAttempts; }
+  uint32_t delayMsec(int attempts) const;
+  uint32_t maxDelayMsec() const { return m_maxDelayMsec; }
+
+  static bool isRetryable(QNetworkReply::NetworkError error, int statusCode);
+
+  static void requestStarted();
+  static bool consumeBudget();
+
+  // For testing only.
+  static void resetBudget();
+
+ private:
+  int m_maxAttempts = 1;
+  uint32_t m_initialDelayMsec = 0;
+  uint32_t m_maxDelayMsec = 0;
+};
+
+#endif  // RETRYPOLICY_H
@@ -10,10 +10,12 @@
 
 #include <functional>
 
+#include <QCryptographicHash>
 #include <QHostAddress>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QTcpSocket>
+#include <QtEndian>
 
 constexpr uint32_t MAX_MSG_SIZE = 1024 * 1024;
 
@@ -24,8 +26,63 @@ Logger logger(LOG_SERVER, "ServerConnection");
 struct RequestType {
   QString m_name;
   std::function<QJsonObject(const QJsonObject&)> m_callback;
+
+  // Used instead of m_callback for responses serialized in advance.
+  std::function<QByteArray(const QJsonObject&)> m_serializedCallback;
+};
+
+// The "servers" response is serialized once per server list. The version is
+// a hash of the list: an extension sending it as "since" receives a response
+// without servers if nothing has changed.
+struct ServersResponse {
+  quint64 m_revision = 0;
+  QString m_version;
+  QByteArray m_full;
+  QByteArray m_unchanged;
 };
 
+ServersResponse s_serversResponse;
+
+const ServersResponse& serversResponse() {
+  const ServerCountryModel* model =
+      MozillaVPN::instance()->serverCountryModel();
+
+  if (!s_serversResponse.m_full.isEmpty() &&
+      s_serversResponse.m_revision == model->revision()) {
+    return s_serversResponse;
+  }
+
+  s_serversResponse = ServersResponse();
+  s_serversResponse.m_revision = model->revision();
+
+  QByteArray serverJson = model->rawJson();
+  if (serverJson.isEmpty()) {
+    return s_serversResponse;
+  }
+
+  logger.log() << "Caching the servers response";
+
+  QJsonDocument doc = QJsonDocument::fromJson(serverJson);
+  Q_ASSERT(doc.isObject());
+
+  s_serversResponse.m_version = QString::fromLatin1(
+      QCryptographicHash::hash(serverJson, QCryptographicHash::Sha256)
+          .toHex()
+          .left(16));
+
+  QJsonObject obj;
+  obj["t"] = "servers";
+  obj["version"] = s_serversResponse.m_version;
+  s_serversResponse.m_unchanged =
+      QJsonDocument(obj).toJson(QJsonDocument::Compact);
+
+  // The extension receives the full server objects, as before the caching.
+  obj["servers"] = doc.object();
+  s_serversResponse.m_full = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+
+  return s_serversResponse;
+}
+
 static QList<RequestType> s_types{
     RequestType{"activate",
                 [](const QJsonObject&) {
@@ -39,22 +96,22 @@ static QList<RequestType> s_types{
                   return QJsonObject();
                 }},
 
-    RequestType{"servers",
-                [](const QJsonObject&) {
-                  QByteArray serverJson =
-                      MozillaVPN::instance()->serverCountryModel()->rawJson();
-                  if (serverJson.isEmpty()) {
-                    return QJsonObject();
+    RequestType{"servers", nullptr,
+                [](const QJsonObject& request) {
+                  const ServersResponse& response = serversResponse();
+                  if (response.m_full.isEmpty()) {
+                    QJsonObject obj;
+                    obj["t"] = "servers";
+                    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
                   }
 
-                  QJsonDocument doc = QJsonDocument::fromJson(serverJson);
-                  Q_ASSERT(doc.isObject());
-
-                  QJsonObject obj;
+                  QJsonValue since = request.value("since");
+                  if (since.isString() &&
+                      since.toString() == response.m_version) {
+                    return response.m_unchanged;
+                  }
 
-                  // TODO: remove some of the unused fields
-                  obj["servers"] = doc.object();
-                  return obj;
+                  return response.m_full;
                 }},
 };
 
@@ -77,13 +134,6 @@ ServerConnection::ServerConnection(QObject* parent, QTcpSocket* connection)
   Q_ASSERT(m_connection);
   connect(m_connection, &QTcpSocket::readyRead, this,
           &ServerConnection::readData);
-
-  MozillaVPN* vpn = MozillaVPN::instance();
-  Q_ASSERT(vpn);
-
-  connect(vpn, &MozillaVPN::stateChanged, this, &ServerConnection::writeState);
-  connect(vpn->controller(), &Controller::stateChanged, this,
-          &ServerConnection::writeState);
 }
 
 ServerConnection::~ServerConnection() {
@@ -92,41 +142,51 @@ ServerConnection::~ServerConnection() {
 }
 
 void ServerConnection::readData() {
-  QByteArray input = m_connection->readAll();
-  m_buffer.append(input);
+  if (m_cursor > 0) {
+    m_buffer.remove(0, m_cursor);
+    m_cursor = 0;
+  }
+
+  m_buffer.append(m_connection->readAll());
+
+  m_processing = true;
+
+  bool completed = false;
+  while (!completed) {
+    int available = m_buffer.length() - m_cursor;
 
-  while (true) {
     switch (m_state) {
       case ReadingLength: {
-        if (m_buffer.length() < 4) {
-          return;
+        if (available < (int)sizeof(uint32_t)) {
+          completed = true;
+          break;
         }
 
-        QByteArray messageLength = m_buffer.left(4);
-        m_buffer.remove(0, 4);
-
+        // The length is in native byte order and it can be unaligned.
         m_messageLength =
-            *reinterpret_cast<const uint32_t*>(messageLength.constData());
+            qFromUnaligned<uint32_t>(m_buffer.constData() + m_cursor);
+        m_cursor += sizeof(uint32_t);
 
         if (!m_messageLength || m_messageLength > MAX_MSG_SIZE) {
+          m_processing = false;
+          m_output.clear();
           m_connection->close();
           return;
         }
 
         m_state = ReadingBody;
-
-        [[fallthrough]];
+        break;
       }
 
       case ReadingBody: {
-        if (m_buffer.length() < (int)m_messageLength) {
-          return;
+        if (available < (int)m_messageLength) {
+          completed = true;
+          break;
         }
 
-        QByteArray message = m_buffer.left(m_messageLength);
-        m_buffer.remove(0, m_messageLength);
-
-        processMessage(message);
+        processMessage(QByteArray::fromRawData(
+            m_buffer.constData() + m_cursor, m_messageLength));
+        m_cursor += m_messageLength;
 
         m_messageLength = 0;
         m_state = ReadingLength;
@@ -135,103 +195,48 @@ void ServerConnection::readData() {
 
       default:
         Q_ASSERT(false);
+        completed = true;
         break;
     }
   }
-}
 
-void ServerConnection::writeData(const QByteArray& data) {
-  uint32_t length = (uint32_t)data.length();
-  char* rawLength = reinterpret_cast<char*>(&length);
+  m_processing = false;
+  flushData();
+}
 
-  if (m_connection->write(rawLength, sizeof(uint32_t)) != sizeof(uint32_t) ||
-      m_connection->write(data.constData(), length) != length) {
-    m_connection->close();
-  }
+// static
+QByteArray ServerConnection::createFrame(const QByteArray& data) {
+  QByteArray frame;
+  frame.reserve(sizeof(uint32_t) + data.length());
+  frame.resize(sizeof(uint32_t));
+  qToUnaligned<uint32_t>(data.length(), frame.data());
+  frame.append(data);
+  return frame;
 }
 
-void ServerConnection::writeState() {
-  MozillaVPN* vpn = MozillaVPN::instance();
-  Q_ASSERT(vpn);
+void ServerConnection::writeData(const QByteArray& data) {
+  writeFrame(createFrame(data));
+}
 
-  QJsonObject obj;
-  obj["t"] = "status";
+void ServerConnection::writeFrame(const QByteArray& frame) {
+  m_output.append(frame);
 
-  {
-    QString stateStr;
-    switch (vpn->state()) {
-      case MozillaVPN::StateInitialize:
-        stateStr = "initialize";
-        break;
-      case MozillaVPN::StateAuthenticating:
-        stateStr = "authenticating";
-        break;
-      case MozillaVPN::StatePostAuthentication:
-        [[fallthrough]];
-      case MozillaVPN::StateTelemetryPolicy:
-        [[fallthrough]];
-      case MozillaVPN::StateMain:
-        stateStr = "ready";
-        break;
-      case MozillaVPN::StateUpdateRequired:
-        stateStr = "updateRequired";
-        break;
-      case MozillaVPN::StateSubscriptionNeeded:
-        stateStr = "subscriptionNeeded";
-        break;
-      case MozillaVPN::StateSubscriptionValidation:
-        stateStr = "subscriptionValidation";
-        break;
-      case MozillaVPN::StateSubscriptionBlocked:
-        stateStr = "subscriptionBlocked";
-        break;
-      case MozillaVPN::StateDeviceLimit:
-        stateStr = "deviceLimit";
-        break;
-      case MozillaVPN::StateBackendFailure:
-        stateStr = "backendFailure";
-        break;
-      default:
-        Q_ASSERT(false);
-        break;
-    }
+  if (!m_processing) {
+    flushData();
+  }
+}
 
-    obj["app"] = stateStr;
+void ServerConnection::flushData() {
+  if (m_output.isEmpty()) {
+    return;
   }
 
-  {
-    QString controllerStateStr;
-    switch (vpn->controller()->state()) {
-      case Controller::StateInitializing:
-        controllerStateStr = "initializing";
-        break;
-      case Controller::StateOff:
-        controllerStateStr = "off";
-        break;
-      case Controller::StateConnecting:
-        controllerStateStr = "connecting";
-        break;
-      case Controller::StateConfirming:
-        controllerStateStr = "confirming";
-        break;
-      case Controller::StateOn:
-        controllerStateStr = "on";
-        break;
-      case Controller::StateDisconnecting:
-        controllerStateStr = "disconnecting";
-        break;
-      case Controller::StateSwitching:
-        controllerStateStr = "switching";
-        break;
-      default:
-        Q_ASSERT(false);
-        break;
-    }
+  QByteArray output;
+  output.swap(m_output);
 
-    obj["vpn"] = controllerStateStr;
+  if (m_connection->write(output) != output.length()) {
+    m_connection->close();
   }
-
-  writeData(QJsonDocument(obj).toJson(QJsonDocument::Compact));
 }
 
 void ServerConnection::writeInvalidRequest() {
@@ -252,6 +257,11 @@ void ServerConnection::processMessage(const QByteArray& message) {
 
   for (const RequestType& type : s_types) {
     if (typeName == type.m_name) {
+      if (type.m_serializedCallback) {
+        writeData(type.m_serializedCallback(obj));
+        return;
+      }
+
       QJsonObject responseObj = type.m_callback(obj);
       responseObj["t"] = typeName;
       writeData(QJsonDocument(responseObj).toJson(QJsonDocument::Compact));
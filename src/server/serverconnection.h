@@ -18,11 +18,17 @@ class ServerConnection final : public QObject {
   ServerConnection(QObject* parent, QTcpSocket* connection);
   ~ServerConnection();
 
+  // Returns the body prefixed by its length, ready to be written by one or
+  // more connections.
+  static QByteArray createFrame(const QByteArray& data);
+
+  void writeFrame(const QByteArray& frame);
+
  private:
   void readData();
   void writeData(const QByteArray& data);
+  void flushData();
 
-  void writeState();
   void writeInvalidRequest();
 
   void processMessage(const QByteArray& message);
@@ -40,8 +46,17 @@ class ServerConnection final : public QObject {
     ReadingBody,
   } m_state = ReadingLength;
 
+  // Messages are parsed in place: the cursor moves forward and the consumed
+  // bytes are dropped once per read.
   QByteArray m_buffer;
+  int m_cursor = 0;
   uint32_t m_messageLength = 0;
+
+  // Length and body of the responses are written together. While the
+  // incoming messages are processed, the responses are queued and sent with
+  // a single write.
+  QByteArray m_output;
+  bool m_processing = false;
 };
 
 #endif  // SERVERCONNECTION_H
@@ -6,14 +6,102 @@
 #include "serverconnection.h"
 #include "leakdetector.h"
 #include "logger.h"
+#include "mozillavpn.h"
 
 #include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QTcpSocket>
 
 namespace {
 Logger logger(LOG_SERVER, "ServerHandler");
+
+QByteArray serializeState() {
+  MozillaVPN* vpn = MozillaVPN::instance();
+  Q_ASSERT(vpn);
+
+  QJsonObject obj;
+  obj["t"] = "status";
+
+  {
+    QString stateStr;
+    switch (vpn->state()) {
+      case MozillaVPN::StateInitialize:
+        stateStr = "initialize";
+        break;
+      case MozillaVPN::StateAuthenticating:
+        stateStr = "authenticating";
+        break;
+      case MozillaVPN::StatePostAuthentication:
+        [[fallthrough]];
+      case MozillaVPN::StateTelemetryPolicy:
+        [[fallthrough]];
+      case MozillaVPN::StateMain:
+        stateStr = "ready";
+        break;
+      case MozillaVPN::StateUpdateRequired:
+        stateStr = "updateRequired";
+        break;
+      case MozillaVPN::StateSubscriptionNeeded:
+        stateStr = "subscriptionNeeded";
+        break;
+      case MozillaVPN::StateSubscriptionValidation:
+        stateStr = "subscriptionValidation";
+        break;
+      case MozillaVPN::StateSubscriptionBlocked:
+        stateStr = "subscriptionBlocked";
+        break;
+      case MozillaVPN::StateDeviceLimit:
+        stateStr = "deviceLimit";
+        break;
+      case MozillaVPN::StateBackendFailure:
+        stateStr = "backendFailure";
+        break;
+      default:
+        Q_ASSERT(false);
+        break;
+    }
+
+    obj["app"] = stateStr;
+  }
+
+  {
+    QString controllerStateStr;
+    switch (vpn->controller()->state()) {
+      case Controller::StateInitializing:
+        controllerStateStr = "initializing";
+        break;
+      case Controller::StateOff:
+        controllerStateStr = "off";
+        break;
+      case Controller::StateConnecting:
+        controllerStateStr = "connecting";
+        break;
+      case Controller::StateConfirming:
+        controllerStateStr = "confirming";
+        break;
+      case Controller::StateOn:
+        controllerStateStr = "on";
+        break;
+      case Controller::StateDisconnecting:
+        controllerStateStr = "disconnecting";
+        break;
+      case Controller::StateSwitching:
+        controllerStateStr = "switching";
+        break;
+      default:
+        Q_ASSERT(false);
+        break;
+    }
+
+    obj["vpn"] = controllerStateStr;
+  }
+
+  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
 }
 
+}  // namespace
+
 constexpr int SERVER_PORT = 8754;
 
 ServerHandler::ServerHandler() {
@@ -28,6 +116,13 @@ ServerHandler::ServerHandler() {
 
   connect(this, &ServerHandler::newConnection, this,
           &ServerHandler::newConnectionReceived);
+
+  MozillaVPN* vpn = MozillaVPN::instance();
+  Q_ASSERT(vpn);
+
+  connect(vpn, &MozillaVPN::stateChanged, this, &ServerHandler::broadcastState);
+  connect(vpn->controller(), &Controller::stateChanged, this,
+          &ServerHandler::broadcastState);
 }
 
 ServerHandler::~ServerHandler() { MVPN_COUNT_DTOR(ServerHandler); }
@@ -38,4 +133,28 @@ void ServerHandler::newConnectionReceived() {
 
   ServerConnection* connection = new ServerConnection(this, child);
   connect(child, &QTcpSocket::disconnected, connection, &QObject::deleteLater);
+
+  m_connections.append(connection);
+  connect(connection, &QObject::destroyed, this,
+          [this, connection]() { m_connections.removeOne(connection); });
+}
+
+void ServerHandler::broadcastState() {
+  // The app and the controller states can change together: let's send each
+  // state once, serialized once for all the connections.
+  QByteArray state = serializeState();
+  if (state == m_lastState) {
+    return;
+  }
+
+  m_lastState = state;
+
+  if (m_connections.isEmpty()) {
+    return;
+  }
+
+  QByteArray frame = ServerConnection::createFrame(state);
+  for (ServerConnection* connection : m_connections) {
+    connection->writeFrame(frame);
+  }
 }
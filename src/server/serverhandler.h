@@ -5,8 +5,11 @@
 #ifndef SERVERHANDLER_H
 #define SERVERHANDLER_H
 
+#include <QList>
 #include <QTcpServer>
 
+class ServerConnection;
+
 class ServerHandler final : public QTcpServer {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(ServerHandler)
@@ -17,6 +20,13 @@ class ServerHandler final : public QTcpServer {
 
  private:
   void newConnectionReceived();
+  void broadcastState();
+
+ private:
+  QList<ServerConnection*> m_connections;
+
+  // The last state sent to the connections.
+  QByteArray m_lastState;
 };
 
 #endif  // SERVERHANDLER_H
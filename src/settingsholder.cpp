@@ -55,6 +55,7 @@ constexpr const char* SETTINGS_POSTAUTHENTICATIONSHOWN =
 constexpr const char* SETTINGS_TELEMETRYPOLICYSHOWN = "telemetryPolicyShown";
 constexpr const char* SETTINGS_PROTECTSELECTEDAPPS = "protectSelectedApps";
 constexpr const char* SETTINGS_VPNDISABLEDAPPS = "vpnDisabledApps";
+constexpr const char* SETTINGS_RESPONSEVALIDATORS = "responseValidators";
 
 #ifdef MVPN_IOS
 constexpr const char* SETTINGS_NATIVEIOSDATAMIGRATED = "nativeIOSDataMigrated";
@@ -147,6 +148,7 @@ void SettingsHolder::clear() {
   m_settings.remove(SETTINGS_SURVEYS);
   m_settings.remove(SETTINGS_IAPPRODUCTS);
   m_settings.remove(SETTINGS_POSTAUTHENTICATIONSHOWN);
+  m_settings.remove(SETTINGS_RESPONSEVALIDATORS);
 
   // We do not remove language, ipv6 and localnetwork settings.
 }
@@ -354,3 +356,27 @@ void SettingsHolder::addConsumedSurvey(const QString& surveyId) {
   list.append(surveyId);
   setConsumedSurveys(list);
 }
+
+bool SettingsHolder::responseValidators(const QString& endpoint,
+                                        QByteArray& eTag,
+                                        QByteArray& lastModified) const {
+  QString prefix = QString("%1/%2/").arg(SETTINGS_RESPONSEVALIDATORS, endpoint);
+  eTag = m_settings.value(prefix + "eTag").toByteArray();
+  lastModified = m_settings.value(prefix + "lastModified").toByteArray();
+  return !eTag.isEmpty() || !lastModified.isEmpty();
+}
+
+void SettingsHolder::setResponseValidators(const QString& endpoint,
+                                           const QByteArray& eTag,
+                                           const QByteArray& lastModified) {
+  logger.log() << "Setting response validators for" << endpoint;
+
+  QString prefix = QString("%1/%2/").arg(SETTINGS_RESPONSEVALIDATORS, endpoint);
+  m_settings.setValue(prefix + "eTag", eTag);
+  m_settings.setValue(prefix + "lastModified", lastModified);
+}
+
+void SettingsHolder::removeResponseValidators() {
+  logger.log() << "Removing response validators";
+  m_settings.remove(SETTINGS_RESPONSEVALIDATORS);
+}
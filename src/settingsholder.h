@@ -94,6 +94,14 @@ class SettingsHolder final : public QObject {
 
   void addConsumedSurvey(const QString& surveyId);
 
+  // HTTP validators (ETag and Last-Modified) of the last successful response
+  // of a cached API endpoint.
+  bool responseValidators(const QString& endpoint, QByteArray& eTag,
+                          QByteArray& lastModified) const;
+  void setResponseValidators(const QString& endpoint, const QByteArray& eTag,
+                             const QByteArray& lastModified);
+  void removeResponseValidators();
+
 #ifdef MVPN_IOS
   GETSET(bool, hasNativeIOSDataMigrated, nativeIOSDataMigrated,
          setNativeIOSDataMigrated)
@@ -48,6 +48,7 @@ SOURCES += \
         commands/commandactivate.cpp \
         commands/commanddeactivate.cpp \
         commands/commanddevice.cpp \
+        commands/commandhistory.cpp \
         commands/commandlogin.cpp \
         commands/commandlogout.cpp \
         commands/commandselect.cpp \
@@ -91,6 +92,7 @@ SOURCES += \
         mozillavpn.cpp \
         networkmanager.cpp \
         networkrequest.cpp \
+        networkrequeststats.cpp \
         networkwatcher.cpp \
         notificationhandler.cpp \
         pinghelper.cpp \
@@ -99,11 +101,13 @@ SOURCES += \
         platforms/dummy/dummynetworkwatcher.cpp \
         qmlengineholder.cpp \
         releasemonitor.cpp \
+        retrypolicy.cpp \
         rfc1918.cpp \
         rfc4193.cpp \
         serveri18n.cpp \
         settingsholder.cpp \
         simplenetworkmanager.cpp \
+        startuptimeline.cpp \
         statusicon.cpp \
         systemtrayhandler.cpp \
         tasks/accountandservers/taskaccountandservers.cpp \
@@ -115,6 +119,8 @@ SOURCES += \
         tasks/heartbeat/taskheartbeat.cpp \
         tasks/removedevice/taskremovedevice.cpp \
         tasks/surveydata/tasksurveydata.cpp \
+        taskscheduler.cpp \
+        throughputhistory.cpp \
         timercontroller.cpp \
         timersingleshot.cpp \
         update/updater.cpp \
@@ -139,6 +145,7 @@ HEADERS += \
         commands/commandactivate.h \
         commands/commanddeactivate.h \
         commands/commanddevice.h \
+        commands/commandhistory.h \
         commands/commandlogin.h \
         commands/commandlogout.h \
         commands/commandselect.h \
@@ -179,6 +186,7 @@ HEADERS += \
         mozillavpn.h \
         networkmanager.h \
         networkrequest.h \
+        networkrequeststats.h \
         networkwatcher.h \
         networkwatcherimpl.h \
         notificationhandler.h \
@@ -189,11 +197,13 @@ HEADERS += \
         platforms/dummy/dummynetworkwatcher.h \
         qmlengineholder.h \
         releasemonitor.h \
+        retrypolicy.h \
         rfc1918.h \
         rfc4193.h \
         serveri18n.h \
         settingsholder.h \
         simplenetworkmanager.h \
+        startuptimeline.h \
         statusicon.h \
         systemtrayhandler.h \
         task.h \
@@ -206,6 +216,8 @@ HEADERS += \
         tasks/heartbeat/taskheartbeat.h \
         tasks/removedevice/taskremovedevice.h \
         tasks/surveydata/tasksurveydata.h \
+        taskscheduler.h \
+        throughputhistory.h \
         timercontroller.h \
         timersingleshot.h \
         update/updater.h \
@@ -259,6 +271,9 @@ unix {
 RESOURCES += qml.qrc
 RESOURCES += ../glean/glean.qrc
 
+# The QML files are compiled ahead of time into the binary.
+CONFIG += qtquickcompiler
+
 QML_IMPORT_PATH =
 QML_DESIGNER_IMPORT_PATH =
 
@@ -349,6 +364,7 @@ else:linux:!android {
             eventlistener.h \
             platforms/linux/backendlogsobserver.h \
             platforms/linux/dbusclient.h \
+            platforms/linux/dbustypes.h \
             platforms/linux/linuxcontroller.h \
             platforms/linux/linuxdependencies.h \
             platforms/linux/linuxnetworkwatcher.h \
@@ -392,6 +408,8 @@ else:linux:!android {
 
     DBUS_ADAPTORS += platforms/linux/daemon/org.mozilla.vpn.dbus.xml
     DBUS_INTERFACES = platforms/linux/daemon/org.mozilla.vpn.dbus.xml
+    QDBUSXML2CPP_ADAPTOR_HEADER_FLAGS += -i platforms/linux/dbustypes.h
+    QDBUSXML2CPP_INTERFACE_HEADER_FLAGS += -i platforms/linux/dbustypes.h
 
     GO_MODULES = ../linux/netfilter/netfilter.go
     
@@ -605,6 +623,7 @@ else:macos {
                    daemon/daemonlocalserver.cpp \
                    daemon/daemonlocalserverconnection.cpp \
                    localsocketcontroller.cpp \
+                   localsocketframing.cpp \
                    wgquickprocess.cpp \
                    platforms/macos/daemon/macosdaemon.cpp \
                    platforms/macos/daemon/macosdaemonserver.cpp
@@ -617,6 +636,7 @@ else:macos {
                    daemon/iputils.h \
                    daemon/wireguardutils.h \
                    localsocketcontroller.h \
+                   localsocketframing.h \
                    wgquickprocess.h \
                    platforms/macos/daemon/macosdaemon.h \
                    platforms/macos/daemon/macosdaemonserver.h
@@ -723,6 +743,7 @@ else:win* {
         daemon/daemonlocalserverconnection.cpp \
         eventlistener.cpp \
         localsocketcontroller.cpp \
+        localsocketframing.cpp \
         platforms/windows/daemon/windowsdaemon.cpp \
         platforms/windows/daemon/windowsdaemonserver.cpp \
         platforms/windows/daemon/windowsdaemontunnel.cpp \
@@ -747,6 +768,7 @@ else:win* {
         daemon/wireguardutils.h \
         eventlistener.h \
         localsocketcontroller.h \
+        localsocketframing.h \
         platforms/windows/daemon/windowsdaemon.h \
         platforms/windows/daemon/windowsdaemonserver.h \
         platforms/windows/daemon/windowsdaemontunnel.h \
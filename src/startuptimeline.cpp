@@ -0,0 +1,146 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "startuptimeline.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+// The startup is made of a few dozens of phases. This is just a safety net.
+constexpr int STARTUP_TIMELINE_MAX_EVENTS = 1024;
+
+namespace {
+
+struct Event {
+  const char* m_name;
+  qint64 m_startNsec;
+  // -1 for the marks.
+  qint64 m_durationNsec;
+  quintptr m_threadId;
+  int m_depth;
+};
+
+QElapsedTimer s_timer;
+QMutex s_mutex;
+QVector<Event> s_events;
+
+thread_local int s_depth = 0;
+
+void addEvent(const char* name, qint64 startNsec, qint64 durationNsec,
+              int depth) {
+  QMutexLocker lock(&s_mutex);
+  if (s_events.length() >= STARTUP_TIMELINE_MAX_EVENTS) {
+    return;
+  }
+
+  s_events.append(Event{name, startNsec, durationNsec,
+                        reinterpret_cast<quintptr>(QThread::currentThreadId()),
+                        depth});
+}
+
+}  // namespace
+
+StartupTimeline::Span::Span(const char* name)
+    : m_name(name), m_startNsec(nowNsec()) {
+  if (m_startNsec >= 0) {
+    ++s_depth;
+  }
+}
+
+StartupTimeline::Span::~Span() {
+  if (m_startNsec < 0) {
+    return;
+  }
+
+  --s_depth;
+  addEvent(m_name, m_startNsec, nowNsec() - m_startNsec, s_depth);
+}
+
+// static
+void StartupTimeline::start() {
+  QMutexLocker lock(&s_mutex);
+  if (!s_timer.isValid()) {
+    s_events.reserve(STARTUP_TIMELINE_MAX_EVENTS);
+    s_timer.start();
+  }
+}
+
+// static
+bool StartupTimeline::isStarted() { return s_timer.isValid(); }
+
+// static
+qint64 StartupTimeline::nowNsec() {
+  return s_timer.isValid() ? s_timer.nsecsElapsed() : -1;
+}
+
+// static
+qint64 StartupTimeline::elapsedMsec() {
+  return s_timer.isValid() ? s_timer.elapsed() : -1;
+}
+
+// static
+void StartupTimeline::record(const char* name, qint64 startNsec) {
+  if (startNsec < 0 || !s_timer.isValid()) {
+    return;
+  }
+
+  addEvent(name, startNsec, nowNsec() - startNsec, s_depth);
+}
+
+// static
+void StartupTimeline::mark(const char* name) {
+  if (!s_timer.isValid()) {
+    return;
+  }
+
+  addEvent(name, nowNsec(), -1, s_depth);
+}
+
+// static
+QJsonObject StartupTimeline::toChromeTrace() {
+  QJsonArray events;
+  double pid = QCoreApplication::applicationPid();
+
+  QMutexLocker lock(&s_mutex);
+  for (const Event& event : s_events) {
+    QJsonObject obj;
+    obj["name"] = event.m_name;
+    obj["cat"] = "startup";
+    obj["pid"] = pid;
+    obj["tid"] = (double)event.m_threadId;
+    // The trace format wants microseconds.
+    obj["ts"] = event.m_startNsec / 1000.0;
+
+    if (event.m_durationNsec < 0) {
+      obj["ph"] = "i";
+      obj["s"] = "p";
+    } else {
+      obj["ph"] = "X";
+      obj["dur"] = event.m_durationNsec / 1000.0;
+    }
+
+    QJsonObject args;
+    args["depth"] = event.m_depth;
+    obj["args"] = args;
+
+    events.append(obj);
+  }
+
+  QJsonObject obj;
+  obj["traceEvents"] = events;
+  obj["displayTimeUnit"] = "ms";
+  return obj;
+}
+
+// static
+void StartupTimeline::reset() {
+  QMutexLocker lock(&s_mutex);
+  s_events.clear();
+  s_timer.invalidate();
+}
@@ -0,0 +1,51 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef STARTUPTIMELINE_H
+#define STARTUPTIMELINE_H
+
+#include <QJsonObject>
+
+// A small recorder of the startup phases. The events are kept in memory from
+// start() and can be exported in the Chrome trace format (chrome://tracing,
+// Perfetto). When the recorder has not been started, the spans cost a single
+// check.
+//
+// The names must be string literals: they are stored as pointers.
+class StartupTimeline final {
+ public:
+  // Records the time spent in a scope. Spans can be nested.
+  class Span final {
+    Q_DISABLE_COPY_MOVE(Span)
+
+   public:
+    explicit Span(const char* name);
+    ~Span();
+
+   private:
+    const char* m_name;
+    qint64 m_startNsec;
+  };
+
+  static void start();
+  static bool isStarted();
+
+  // Nsecs since start(), monotonic. -1 if the recorder is not started.
+  static qint64 nowNsec();
+  static qint64 elapsedMsec();
+
+  // For the phases which do not match a scope. "startNsec" is a value
+  // returned by nowNsec().
+  static void record(const char* name, qint64 startNsec);
+
+  // A single point in time.
+  static void mark(const char* name);
+
+  static QJsonObject toChromeTrace();
+
+  // For testing only.
+  static void reset();
+};
+
+#endif  // STARTUPTIMELINE_H
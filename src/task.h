@@ -13,18 +13,40 @@ class Task : public QObject {
   Q_OBJECT
 
  public:
-  explicit Task(const QString& name) : m_name(name) {}
+  // Tasks sharing at least one group are executed in the order they are
+  // scheduled. Tasks without groups in common can run concurrently.
+  enum Group : uint32_t {
+    GroupAccount = 1 << 0,
+    GroupCaptivePortal = 1 << 1,
+    GroupController = 1 << 2,
+    GroupHeartbeat = 1 << 3,
+    GroupSurvey = 1 << 4,
+
+    // A task in this group waits for all the previous tasks and blocks all
+    // the following ones.
+    GroupAll = 0xFFFFFFFF,
+  };
+
+  explicit Task(const QString& name, uint32_t groups = GroupAll)
+      : m_name(name), m_groups(groups) {}
   virtual ~Task() = default;
 
   const QString& name() const { return m_name; }
 
+  uint32_t groups() const { return m_groups; }
+
   virtual void run(MozillaVPN* vpn) = 0;
 
+  // Tasks with the same non-empty key do the same work. A task is dropped if
+  // another one with the same key is already waiting to be executed.
+  virtual QString coalescingKey() const { return QString(); }
+
  signals:
   void completed();
 
  private:
   QString m_name;
+  uint32_t m_groups;
 };
 
 #endif  // TASK_H
@@ -14,7 +14,8 @@ namespace {
 Logger logger(LOG_MAIN, "TaskAccountAndServers");
 }
 
-TaskAccountAndServers::TaskAccountAndServers() : Task("TaskAccountAndServers") {
+TaskAccountAndServers::TaskAccountAndServers()
+    : Task("TaskAccountAndServers", Task::GroupAccount) {
   MVPN_COUNT_CTOR(TaskAccountAndServers);
 }
 
@@ -44,6 +45,12 @@ void TaskAccountAndServers::run(MozillaVPN* vpn) {
               m_accountCompleted = true;
               maybeCompleted();
             });
+
+    connect(request, &NetworkRequest::requestUnchanged, [this]() {
+      logger.log() << "Account unchanged";
+      m_accountCompleted = true;
+      maybeCompleted();
+    });
   }
 
   // Server list fetch
@@ -65,6 +72,12 @@ void TaskAccountAndServers::run(MozillaVPN* vpn) {
               m_serversCompleted = true;
               maybeCompleted();
             });
+
+    connect(request, &NetworkRequest::requestUnchanged, [this]() {
+      logger.log() << "Servers unchanged";
+      m_serversCompleted = true;
+      maybeCompleted();
+    });
   }
 }
 
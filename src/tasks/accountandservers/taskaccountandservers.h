@@ -19,6 +19,8 @@ class TaskAccountAndServers final : public Task {
 
   void run(MozillaVPN* vpn) override;
 
+  QString coalescingKey() const override { return name(); }
+
  private:
   void maybeCompleted();
 
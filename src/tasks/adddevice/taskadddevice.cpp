@@ -33,7 +33,7 @@ QByteArray generatePrivateKey() {
 }  // anonymous namespace
 
 TaskAddDevice::TaskAddDevice(const QString& deviceName)
-    : Task("TaskAddDevice"), m_deviceName(deviceName) {
+    : Task("TaskAddDevice", Task::GroupAccount), m_deviceName(deviceName) {
   MVPN_COUNT_CTOR(TaskAddDevice);
 }
 
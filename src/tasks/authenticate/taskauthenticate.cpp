@@ -41,7 +41,8 @@ QByteArray generatePkceCodeVerifier() {
 
 }  // anonymous namespace
 
-TaskAuthenticate::TaskAuthenticate() : Task("TaskAuthenticate") {
+TaskAuthenticate::TaskAuthenticate()
+    : Task("TaskAuthenticate", Task::GroupAccount) {
   MVPN_COUNT_CTOR(TaskAuthenticate);
 }
 
@@ -14,7 +14,7 @@ Logger logger(LOG_NETWORKING, "TaskCaptivePortalLookup");
 }
 
 TaskCaptivePortalLookup::TaskCaptivePortalLookup()
-    : Task("TaskCaptivePortalLookup") {
+    : Task("TaskCaptivePortalLookup", Task::GroupCaptivePortal) {
   MVPN_COUNT_CTOR(TaskCaptivePortalLookup);
 }
 
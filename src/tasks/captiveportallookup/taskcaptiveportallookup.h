@@ -17,6 +17,8 @@ class TaskCaptivePortalLookup final : public Task {
   ~TaskCaptivePortalLookup();
 
   void run(MozillaVPN* vpn) override;
+
+  QString coalescingKey() const override { return name(); }
 };
 
 #endif  // TASKCAPTIVEPORTALLOOKUP_H
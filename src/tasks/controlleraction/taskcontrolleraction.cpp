@@ -15,7 +15,7 @@ Logger logger(QStringList{LOG_MAIN, LOG_CONTROLLER}, "TaskControllerAction");
 
 TaskControllerAction::TaskControllerAction(
     TaskControllerAction::TaskAction action)
-    : Task("TaskControllerAction"), m_action(action) {
+    : Task("TaskControllerAction", Task::GroupController), m_action(action) {
   MVPN_COUNT_CTOR(TaskControllerAction);
 
   logger.log() << "TaskControllerAction created for"
@@ -5,8 +5,9 @@
 #include "taskfunction.h"
 #include "leakdetector.h"
 
-TaskFunction::TaskFunction(std::function<void(MozillaVPN*)>&& callback)
-    : Task("TaskFunction"), m_callback(std::move(callback)) {
+TaskFunction::TaskFunction(std::function<void(MozillaVPN*)>&& callback,
+                           uint32_t groups)
+    : Task("TaskFunction", groups), m_callback(std::move(callback)) {
   MVPN_COUNT_CTOR(TaskFunction);
 }
 
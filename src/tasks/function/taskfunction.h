@@ -14,7 +14,8 @@ class TaskFunction final : public Task {
   Q_DISABLE_COPY_MOVE(TaskFunction)
 
  public:
-  TaskFunction(std::function<void(MozillaVPN*)>&& callback);
+  TaskFunction(std::function<void(MozillaVPN*)>&& callback,
+               uint32_t groups = Task::GroupAll);
   ~TaskFunction();
 
   void run(MozillaVPN* vpn) override;
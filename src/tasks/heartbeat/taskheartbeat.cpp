@@ -15,7 +15,8 @@ namespace {
 Logger logger(LOG_MAIN, "TaskHeartbeat");
 }
 
-TaskHeartbeat::TaskHeartbeat() : Task("TaskHeartbeat") {
+TaskHeartbeat::TaskHeartbeat()
+    : Task("TaskHeartbeat", Task::GroupHeartbeat) {
   MVPN_COUNT_CTOR(TaskHeartbeat);
 }
 
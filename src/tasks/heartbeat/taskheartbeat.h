@@ -17,6 +17,8 @@ class TaskHeartbeat final : public Task {
   ~TaskHeartbeat();
 
   void run(MozillaVPN* vpn) override;
+
+  QString coalescingKey() const override { return name(); }
 };
 
 #endif  // TASKHEARTBEAT_H
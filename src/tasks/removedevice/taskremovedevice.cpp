@@ -15,7 +15,7 @@ Logger logger(LOG_MAIN, "TaskRemoveDevice");
 }
 
 TaskRemoveDevice::TaskRemoveDevice(const QString& publicKey)
-    : Task("TaskRemoveDevice"), m_publicKey(publicKey) {
+    : Task("TaskRemoveDevice", Task::GroupAccount), m_publicKey(publicKey) {
   MVPN_COUNT_CTOR(TaskRemoveDevice);
 }
 
@@ -13,7 +13,8 @@ namespace {
 Logger logger(LOG_MAIN, "TaskSurveyData");
 }
 
-TaskSurveyData::TaskSurveyData() : Task("TaskSurveyData") {
+TaskSurveyData::TaskSurveyData()
+    : Task("TaskSurveyData", Task::GroupSurvey) {
   MVPN_COUNT_CTOR(TaskSurveyData);
 }
 
@@ -36,4 +37,9 @@ void TaskSurveyData::run(MozillaVPN* vpn) {
             vpn->surveyChecked(data);
             emit completed();
           });
+
+  connect(request, &NetworkRequest::requestUnchanged, [this]() {
+    logger.log() << "Survey data unchanged";
+    emit completed();
+  });
 }
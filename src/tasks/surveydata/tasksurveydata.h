@@ -17,6 +17,8 @@ class TaskSurveyData final : public Task {
   ~TaskSurveyData();
 
   void run(MozillaVPN* vpn) override;
+
+  QString coalescingKey() const override { return name(); }
 };
 
 #endif  // TASKSURVEYDATA_H
@@ -0,0 +1,169 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "taskscheduler.h"
+#include "leakdetector.h"
+#include "logger.h"
+#include "mozillavpn.h"
+#include "task.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+namespace {
+Logger logger(LOG_MAIN, "TaskScheduler");
+}
+
+TaskScheduler::TaskScheduler() { MVPN_COUNT_CTOR(TaskScheduler); }
+
+TaskScheduler::~TaskScheduler() {
+  MVPN_COUNT_DTOR(TaskScheduler);
+  deleteTasks();
+}
+
+void TaskScheduler::scheduleTask(Task* task) {
+  Q_ASSERT(task);
+  logger.log() << "Scheduling task: " << task->name();
+
+  ++m_scheduledTasks;
+
+  // The new task is dropped only if an equivalent one is the last pending
+  // task of its groups: a task scheduled after the duplicate (for instance
+  // TaskAddDevice) needs the new task to run after it.
+  QString key = task->coalescingKey();
+  if (!key.isEmpty()) {
+    for (int i = m_pendingTasks.length() - 1; i >= 0; --i) {
+      const Task* pendingTask = m_pendingTasks.at(i).m_task;
+      if (pendingTask->coalescingKey() == key) {
+        logger.log() << "Task already pending. Coalescing:" << key;
+        ++m_coalescedTasks;
+        task->deleteLater();
+        return;
+      }
+
+      if (pendingTask->groups() & task->groups()) {
+        break;
+      }
+    }
+  }
+
+  PendingTask pendingTask{task, QElapsedTimer()};
+  pendingTask.m_timer.start();
+  m_pendingTasks.append(pendingTask);
+
+  maybeRunTasks();
+}
+
+void TaskScheduler::maybeRunTasks() {
+  // A task can complete synchronously in its run() method. If this happens,
+  // the loop below takes care of the following tasks.
+  if (m_dispatching) {
+    return;
+  }
+
+  m_dispatching = true;
+
+  while (true) {
+    int index = nextRunnableTask();
+    if (index == -1) {
+      break;
+    }
+
+    PendingTask pendingTask = m_pendingTasks.takeAt(index);
+    Task* task = pendingTask.m_task;
+
+    qint64 waitMsec = pendingTask.m_timer.elapsed();
+    ++m_startedTasks;
+    m_totalWaitMsec += waitMsec;
+    m_maxWaitMsec = qMax(m_maxWaitMsec, waitMsec);
+
+    logger.log() << "Running task:" << task->name() << "waited (msec):"
+                 << waitMsec << "pending:" << m_pendingTasks.length()
+                 << "running:" << m_runningTasks.length();
+
+    m_runningTasks.append(task);
+    connect(task, &Task::completed, this, &TaskScheduler::taskCompleted);
+
+    task->run(MozillaVPN::instance());
+  }
+
+  m_dispatching = false;
+}
+
+int TaskScheduler::nextRunnableTask() const {
+  uint32_t busyGroups = 0;
+  for (const Task* task : m_runningTasks) {
+    busyGroups |= task->groups();
+  }
+
+  for (int i = 0; i < m_pendingTasks.length(); ++i) {
+    uint32_t groups = m_pendingTasks[i].m_task->groups();
+    if ((groups & busyGroups) == 0) {
+      return i;
+    }
+
+    // Pending tasks keep their order within the same groups.
+    busyGroups |= groups;
+  }
+
+  return -1;
+}
+
+void TaskScheduler::taskCompleted() {
+  Task* task = qobject_cast<Task*>(sender());
+  Q_ASSERT(task);
+
+  logger.log() << "Task completed:" << task->name();
+
+  Q_ASSERT(m_runningTasks.contains(task));
+  m_runningTasks.removeOne(task);
+
+  task->deleteLater();
+  task->disconnect();
+
+  maybeRunTasks();
+}
+
+void TaskScheduler::deleteTasks() {
+  for (const PendingTask& pendingTask : m_pendingTasks) {
+    pendingTask.m_task->deleteLater();
+  }
+
+  m_pendingTasks.clear();
+
+  for (Task* task : m_runningTasks) {
+    task->deleteLater();
+    task->disconnect();
+  }
+
+  m_runningTasks.clear();
+}
+
+QJsonObject TaskScheduler::status() const {
+  QJsonArray pending;
+  for (const PendingTask& pendingTask : m_pendingTasks) {
+    QJsonObject obj;
+    obj["name"] = pendingTask.m_task->name();
+    obj["waitMsec"] = pendingTask.m_timer.elapsed();
+    pending.append(obj);
+  }
+
+  QJsonArray running;
+  for (const Task* task : m_runningTasks) {
+    running.append(task->name());
+  }
+
+  QJsonObject obj;
+  obj["pending"] = pending;
+  obj["running"] = running;
+  obj["scheduledTasks"] = (double)m_scheduledTasks;
+  obj["coalescedTasks"] = (double)m_coalescedTasks;
+  obj["coalescingRate"] =
+      m_scheduledTasks ? (double)m_coalescedTasks / m_scheduledTasks : 0.0;
+  obj["startedTasks"] = (double)m_startedTasks;
+  obj["averageWaitMsec"] =
+      m_startedTasks ? (double)m_totalWaitMsec / m_startedTasks : 0.0;
+  obj["maxWaitMsec"] = (double)m_maxWaitMsec;
+  return obj;
+}
@@ -0,0 +1,64 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+
+class QJsonObject;
+class Task;
+
+// Tasks are executed in the order they are scheduled, but a task does not
+// wait for the previous ones if they do not share any group with it (see
+// Task::Group). Tasks in the same group are never executed concurrently.
+// A task is dropped if an equivalent one (see Task::coalescingKey()) is
+// already pending and no other task of the same groups is scheduled after it.
+class TaskScheduler final : public QObject {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(TaskScheduler)
+
+ public:
+  TaskScheduler();
+  ~TaskScheduler();
+
+  void scheduleTask(Task* task);
+
+  void deleteTasks();
+
+  int pendingTasks() const { return m_pendingTasks.length(); }
+  int runningTasks() const { return m_runningTasks.length(); }
+
+  // Queue depth and wait times, for debugging.
+  QJsonObject status() const;
+
+ private:
+  void maybeRunTasks();
+
+  int nextRunnableTask() const;
+
+  void taskCompleted();
+
+ private:
+  struct PendingTask {
+    Task* m_task;
+    QElapsedTimer m_timer;
+  };
+
+  QList<PendingTask> m_pendingTasks;
+  QList<Task*> m_runningTasks;
+
+  bool m_dispatching = false;
+
+  // Stats.
+  uint64_t m_scheduledTasks = 0;
+  uint64_t m_coalescedTasks = 0;
+  uint64_t m_startedTasks = 0;
+  qint64 m_totalWaitMsec = 0;
+  qint64 m_maxWaitMsec = 0;
+};
+
+#endif  // TASKSCHEDULER_H
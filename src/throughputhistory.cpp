@@ -0,0 +1,315 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "throughputhistory.h"
+#include "constants.h"
+#include "leakdetector.h"
+#include "logger.h"
+#include "mozillavpn.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVariantMap>
+
+// 10 minutes of seconds, 1 day of minutes, 90 days of hours.
+constexpr int HISTORY_SECONDS = 600;
+constexpr int HISTORY_MINUTES = 1440;
+constexpr int HISTORY_HOURS = 2160;
+
+constexpr const char* HISTORY_FILENAME = "throughput.dat";
+constexpr quint32 HISTORY_MAGIC = 0x4d565448;  // MVTH
+constexpr quint8 HISTORY_VERSION = 1;
+
+namespace {
+Logger logger(LOG_MAIN, "ThroughputHistory");
+}
+
+ThroughputHistory::Tier::Tier(qint64 bucketSecs, int capacity)
+    : m_bucketSecs(bucketSecs) {
+  m_samples.resize(capacity);
+}
+
+bool ThroughputHistory::Tier::add(qint64 time, quint64 txBytes,
+                                  quint64 rxBytes) {
+  qint64 bucket = time - (time % m_bucketSecs);
+
+  // The clock can go backward. Let's add the bytes to the last bucket.
+  if (m_count && at(m_count - 1).m_time >= bucket) {
+    Sample& last = m_samples[(m_head + m_count - 1) % m_samples.length()];
+    last.m_txBytes += txBytes;
+    last.m_rxBytes += rxBytes;
+    return false;
+  }
+
+  Sample sample;
+  sample.m_time = bucket;
+  sample.m_txBytes = txBytes;
+  sample.m_rxBytes = rxBytes;
+  append(sample);
+  return true;
+}
+
+void ThroughputHistory::Tier::append(const Sample& sample) {
+  if (m_count < m_samples.length()) {
+    m_samples[(m_head + m_count) % m_samples.length()] = sample;
+    ++m_count;
+    return;
+  }
+
+  m_samples[m_head] = sample;
+  m_head = (m_head + 1) % m_samples.length();
+}
+
+void ThroughputHistory::Tier::clear() {
+  m_head = 0;
+  m_count = 0;
+}
+
+const ThroughputHistory::Sample& ThroughputHistory::Tier::at(int index) const {
+  Q_ASSERT(index >= 0 && index < m_count);
+  return m_samples.at((m_head + index) % m_samples.length());
+}
+
+ThroughputHistory::ThroughputHistory()
+    : m_tiers{{1, HISTORY_SECONDS},
+              {60, HISTORY_MINUTES},
+              {3600, HISTORY_HOURS}} {
+  MVPN_COUNT_CTOR(ThroughputHistory);
+
+  connect(&m_checkStatusTimer, &QTimer::timeout, this,
+          &ThroughputHistory::checkStatus);
+}
+
+ThroughputHistory::~ThroughputHistory() {
+  MVPN_COUNT_DTOR(ThroughputHistory);
+
+  // The VPN is still active when the app quits.
+  if (m_checkStatusTimer.isActive()) {
+    save();
+  }
+}
+
+void ThroughputHistory::initialize() {
+  if (!load()) {
+    logger.log() << "No throughput history";
+  }
+}
+
+void ThroughputHistory::stateChanged() {
+  Controller::State state = MozillaVPN::instance()->controller()->state();
+  if (state == Controller::StateOn) {
+    if (!m_checkStatusTimer.isActive()) {
+      m_checkStatusTimer.start(Constants::CHECKSTATUS_TIMER_MSEC);
+    }
+    return;
+  }
+
+  if (m_checkStatusTimer.isActive()) {
+    m_checkStatusTimer.stop();
+    save();
+  }
+
+  // The next tunnel starts its counters from 0.
+  m_hasLastBytes = false;
+}
+
+void ThroughputHistory::checkStatus() {
+  MozillaVPN::instance()->controller()->getStatus(
+      [this](const QString& serverIpv4Gateway, const QString& deviceIpv4Address,
+             uint64_t txBytes, uint64_t rxBytes) {
+        Q_UNUSED(deviceIpv4Address);
+        if (serverIpv4Gateway.isEmpty()) {
+          return;
+        }
+
+        // A smaller value means that the tunnel has been recreated.
+        // The file is small and replaced atomically: let's save it at every
+        // minute, so that the history command sees the recent traffic.
+        if (m_hasLastBytes && txBytes >= m_lastTxBytes &&
+            rxBytes >= m_lastRxBytes &&
+            addSample(QDateTime::currentSecsSinceEpoch(),
+                      txBytes - m_lastTxBytes, rxBytes - m_lastRxBytes)) {
+          save();
+        }
+
+        m_hasLastBytes = true;
+        m_lastTxBytes = txBytes;
+        m_lastRxBytes = rxBytes;
+      });
+}
+
+bool ThroughputHistory::addSample(qint64 time, quint64 txBytes,
+                                  quint64 rxBytes) {
+  bool newMinute = false;
+  for (int i = 0; i < 3; ++i) {
+    bool newBucket = m_tiers[i].add(time, txBytes, rxBytes);
+    if (i == Minutes) {
+      newMinute = newBucket && m_tiers[i].count() > 1;
+    }
+  }
+  return newMinute;
+}
+
+QList<ThroughputHistory::Sample> ThroughputHistory::query(
+    qint64 from, qint64 to, Resolution resolution) const {
+  const Tier& tier = m_tiers[resolution];
+
+  QList<Sample> list;
+  for (int i = 0; i < tier.count(); ++i) {
+    const Sample& sample = tier.at(i);
+    if (sample.m_time + tier.bucketSecs() <= from) {
+      continue;
+    }
+    if (sample.m_time > to) {
+      break;
+    }
+    list.append(sample);
+  }
+
+  return list;
+}
+
+ThroughputHistory::Resolution ThroughputHistory::resolutionFor(
+    qint64 from, qint64 now) const {
+  if (now - from <= HISTORY_SECONDS) {
+    return Seconds;
+  }
+
+  if (now - from <= HISTORY_MINUTES * 60) {
+    return Minutes;
+  }
+
+  return Hours;
+}
+
+QVariantList ThroughputHistory::samples(qint64 from, qint64 to) const {
+  from /= 1000;
+  to /= 1000;
+
+  QVariantList list;
+  for (const Sample& sample :
+       query(from, to,
+             resolutionFor(from, QDateTime::currentSecsSinceEpoch()))) {
+    QVariantMap obj;
+    obj["time"] = sample.m_time * 1000;
+    obj["txBytes"] = sample.m_txBytes;
+    obj["rxBytes"] = sample.m_rxBytes;
+    list.append(obj);
+  }
+
+  return list;
+}
+
+QByteArray ThroughputHistory::serialize() const {
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_5_0);
+
+  stream << HISTORY_MAGIC << HISTORY_VERSION;
+
+  // The times are stored as deltas from the previous sample: the buckets are
+  // sorted.
+  for (const Tier& tier : m_tiers) {
+    stream << (quint32)tier.count();
+
+    qint64 previousTime = 0;
+    for (int i = 0; i < tier.count(); ++i) {
+      const Sample& sample = tier.at(i);
+      if (i == 0) {
+        stream << sample.m_time;
+      } else {
+        stream << (quint32)(sample.m_time - previousTime);
+      }
+      stream << sample.m_txBytes << sample.m_rxBytes;
+      previousTime = sample.m_time;
+    }
+  }
+
+  return data;
+}
+
+bool ThroughputHistory::deserialize(const QByteArray& data) {
+  QDataStream stream(data);
+  stream.setVersion(QDataStream::Qt_5_0);
+
+  quint32 magic = 0;
+  quint8 version = 0;
+  stream >> magic >> version;
+  if (magic != HISTORY_MAGIC || version != HISTORY_VERSION) {
+    logger.log() << "Invalid throughput history header";
+    return false;
+  }
+
+  Tier tiers[3] = {m_tiers[Seconds], m_tiers[Minutes], m_tiers[Hours]};
+  for (Tier& tier : tiers) {
+    tier.clear();
+
+    quint32 count = 0;
+    stream >> count;
+
+    qint64 time = 0;
+    for (quint32 i = 0; i < count; ++i) {
+      if (i == 0) {
+        stream >> time;
+      } else {
+        quint32 delta = 0;
+        stream >> delta;
+        time += delta;
+      }
+
+      Sample sample;
+      sample.m_time = time;
+      stream >> sample.m_txBytes >> sample.m_rxBytes;
+
+      if (stream.status() != QDataStream::Ok) {
+        logger.log() << "Truncated throughput history";
+        return false;
+      }
+
+      tier.append(sample);
+    }
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    m_tiers[i] = tiers[i];
+  }
+
+  return true;
+}
+
+// static
+QString ThroughputHistory::filePath() {
+  QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+  return dir.filePath(HISTORY_FILENAME);
+}
+
+bool ThroughputHistory::load() {
+  QFile file(filePath());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  return deserialize(file.readAll());
+}
+
+bool ThroughputHistory::save() const {
+  QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+  if (!dir.exists() && !dir.mkpath(".")) {
+    logger.log() << "Failed to create the history folder";
+    return false;
+  }
+
+  QSaveFile file(filePath());
+  if (!file.open(QIODevice::WriteOnly)) {
+    logger.log() << "Failed to open the history file";
+    return false;
+  }
+
+  file.write(serialize());
+  return file.commit();
+}
@@ -0,0 +1,102 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef THROUGHPUTHISTORY_H
+#define THROUGHPUTHISTORY_H
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+#include <QVariantList>
+#include <QVector>
+
+// The bytes sent and received through the VPN tunnel, in 3 tiers of fixed
+// size: per second, per minute and per hour. Each sample is added to all the
+// tiers, so the old samples are dropped from the fine tiers first. The
+// history is stored between sessions.
+class ThroughputHistory final : public QObject {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(ThroughputHistory)
+
+ public:
+  enum Resolution {
+    Seconds = 0,
+    Minutes,
+    Hours,
+  };
+  Q_ENUM(Resolution)
+
+  struct Sample {
+    // Seconds since the epoch, at the beginning of the bucket.
+    qint64 m_time = 0;
+    quint64 m_txBytes = 0;
+    quint64 m_rxBytes = 0;
+  };
+
+  ThroughputHistory();
+  ~ThroughputHistory();
+
+  void initialize();
+
+  // "time" is in seconds since the epoch. Returns true if the sample closes a
+  // minute bucket.
+  bool addSample(qint64 time, quint64 txBytes, quint64 rxBytes);
+
+  // The samples with a bucket in [from, to], the oldest first.
+  QList<Sample> query(qint64 from, qint64 to, Resolution resolution) const;
+
+  // The finest resolution which still has the samples since "from".
+  Resolution resolutionFor(qint64 from, qint64 now) const;
+
+  // For QML: a list of {time, txBytes, rxBytes} objects, with the best
+  // resolution for the range. "from" and "to" are in msecs since the epoch.
+  Q_INVOKABLE QVariantList samples(qint64 from, qint64 to) const;
+
+  QByteArray serialize() const;
+  bool deserialize(const QByteArray& data);
+
+  bool load();
+  bool save() const;
+
+  static QString filePath();
+
+ public slots:
+  void stateChanged();
+
+ private:
+  void checkStatus();
+
+  class Tier final {
+   public:
+    Tier(qint64 bucketSecs, int capacity);
+
+    // Returns true if a new bucket has been started.
+    bool add(qint64 time, quint64 txBytes, quint64 rxBytes);
+    void append(const Sample& sample);
+    void clear();
+
+    qint64 bucketSecs() const { return m_bucketSecs; }
+    int count() const { return m_count; }
+    const Sample& at(int index) const;
+
+   private:
+    qint64 m_bucketSecs;
+    QVector<Sample> m_samples;
+    int m_head = 0;
+    int m_count = 0;
+  };
+
+ private:
+  Tier m_tiers[3];
+
+  // The counters of the tunnel are cumulative. We store the deltas.
+  bool m_hasLastBytes = false;
+  quint64 m_lastTxBytes = 0;
+  quint64 m_lastRxBytes = 0;
+
+  QTimer m_checkStatusTimer;
+};
+
+#endif  // THROUGHPUTHISTORY_H
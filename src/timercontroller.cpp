@@ -154,4 +154,12 @@ void TimerController::getBackendLogs(
   m_impl->getBackendLogs(std::move(callback));
 }
 
+void TimerController::getBackendLogsChunk(
+    const QString& cursor,
+    std::function<void(const QString&, const QString&)>&& a_callback) {
+  std::function<void(const QString&, const QString&)> callback =
+      std::move(a_callback);
+  m_impl->getBackendLogsChunk(cursor, std::move(callback));
+}
+
 void TimerController::cleanupBackendLogs() { m_impl->cleanupBackendLogs(); }
@@ -35,6 +35,10 @@ class TimerController final : public ControllerImpl {
 
   void getBackendLogs(std::function<void(const QString&)>&& callback) override;
 
+  void getBackendLogsChunk(
+      const QString& cursor,
+      std::function<void(const QString&, const QString&)>&& callback) override;
+
   void cleanupBackendLogs() override;
 
  private slots:
@@ -512,7 +512,7 @@ Rectangle {
 
         onClicked: {
             Glean.sample.settingsViewOpened.record();
-            stackview.push("../views/ViewSettings.qml", StackView.Immediate)
+            stackview.pushCached(Qt.resolvedUrl("../views/ViewSettings.qml"), StackView.Immediate)
         }
 
         anchors.top: parent.top
@@ -544,7 +544,7 @@ Rectangle {
                 while(stackview.depth > 1) {
                     stackview.pop(null, StackView.Immediate);
                 }
-                stackview.push("../views/ViewSettings.qml", StackView.Immediate);
+                stackview.pushCached(Qt.resolvedUrl("../views/ViewSettings.qml"), StackView.Immediate);
             }
             function onAboutNeeded() {
                 while(stackview.depth > 1) {
@@ -12,6 +12,36 @@ StackView {
     id: stackView
     Component.onCompleted: VPNCloseEventHandler.addStackView(stackView)
 
+    // The heavy views are created at the first push and reused after that.
+    // StackView does not destroy the items it has not created.
+    property var cachedViews: ({})
+
+    function pushCached(url, operation) {
+        let view = cachedViews[url];
+        if (!view) {
+            const component = Qt.createComponent(url);
+            if (component.status !== Component.Ready) {
+                console.log("Unable to load", url, component.errorString());
+                return;
+            }
+
+            view = component.createObject(stackView, { visible: false });
+            cachedViews[url] = view;
+        }
+
+        // The view is already in the stack.
+        if (stackView.find(item => item === view)) {
+            stackView.pop(view, StackView.Immediate);
+            return;
+        }
+
+        if (operation === undefined) {
+            stackView.push(view);
+        } else {
+            stackView.push(view, operation);
+        }
+    }
+
     Connections {
         target: VPNCloseEventHandler
         function onGoBack(item) {
@@ -13,4 +13,7 @@ VPNStackView {
     id: settingsStackView
 
     initialItem: "../settings/ViewSettingsMenu.qml"
+
+    // This view is cached by the parent stack: it restarts from the menu.
+    StackView.onRemoved: settingsStackView.pop(null, StackView.Immediate)
 }
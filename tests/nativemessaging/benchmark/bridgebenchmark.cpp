@@ -0,0 +1,290 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "bridgebenchmark.h"
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QVector>
+#include <QtEndian>
+
+constexpr int WAIT_MSEC = 5000;
+
+// Message sizes: from a status message to a full server list.
+constexpr int MESSAGE_SIZES[] = {64, 1024, 16 * 1024, 256 * 1024};
+
+// For the throughput, the messages are sent without waiting for the replies.
+constexpr int PIPELINE_MAX_BYTES = 16 * 1024 * 1024;
+constexpr int PIPELINE_MAX_MESSAGES = 1000;
+
+namespace {
+
+// A JSON message of about `size` bytes.
+QByteArray createMessage(int size) {
+  QJsonObject obj;
+  obj["t"] = "benchmark";
+  obj["p"] = QString(qMax(0, size - 24), 'x');
+  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+QByteArray createRequest(const QString& type,
+                         const QString& since = QString()) {
+  QJsonObject obj;
+  obj["t"] = type;
+  if (!since.isEmpty()) {
+    obj["since"] = since;
+  }
+  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+QJsonObject parseMessage(const QByteArray& message) {
+  return QJsonDocument::fromJson(message).object();
+}
+
+qint64 percentile(const QVector<qint64>& sorted, int p) {
+  Q_ASSERT(!sorted.isEmpty());
+  return sorted[qMin(sorted.length() - 1, sorted.length() * p / 100)];
+}
+
+}  // namespace
+
+BridgeBenchmark::BridgeBenchmark(const QString& app, int iterations,
+                                 Target target)
+    : m_app(app), m_iterations(qMax(1, iterations)), m_target(target) {}
+
+BridgeBenchmark::~BridgeBenchmark() {
+  if (m_process.state() != QProcess::NotRunning) {
+    stop();
+  }
+}
+
+QJsonObject BridgeBenchmark::run() {
+  if (!start()) {
+    qWarning("Failed to start the native messaging bridge");
+    return QJsonObject();
+  }
+
+  QJsonObject obj = m_target == Echo ? runEcho() : runClient();
+  if (!obj.isEmpty()) {
+    obj["iterations"] = m_iterations;
+    obj["bridgeMaxRssKb"] = bridgeMaxRssKb();
+  }
+
+  stop();
+  return obj;
+}
+
+QJsonObject BridgeBenchmark::runEcho() {
+  QJsonArray results;
+  for (int size : MESSAGE_SIZES) {
+    QJsonObject result = measure(createMessage(size));
+    if (result.isEmpty()) {
+      return QJsonObject();
+    }
+
+    results.append(result);
+  }
+
+  QJsonObject obj;
+  obj["target"] = "echo";
+  obj["results"] = results;
+  return obj;
+}
+
+// The VPN client answers the "servers" request with the full server list, or
+// with a short response if the list has not changed since the version sent
+// by the extension: the two ends of the real traffic.
+QJsonObject BridgeBenchmark::runClient() {
+  QByteArray reply;
+  if (!writeMessage(createRequest("servers")) || !readMessage(reply)) {
+    qWarning("The VPN client does not reply");
+    return QJsonObject();
+  }
+
+  QString version = parseMessage(reply).value("version").toString();
+  if (version.isEmpty()) {
+    qWarning("No server list. Is the VPN client authenticated?");
+    return QJsonObject();
+  }
+
+  QJsonArray results;
+  for (const QByteArray& request :
+       {createRequest("servers"), createRequest("servers", version)}) {
+    QJsonObject result = measure(request);
+    if (result.isEmpty()) {
+      return QJsonObject();
+    }
+
+    results.append(result);
+  }
+
+  QJsonObject obj;
+  obj["target"] = "client";
+  obj["results"] = results;
+  return obj;
+}
+
+bool BridgeBenchmark::start() {
+  m_process.setReadChannel(QProcess::StandardOutput);
+
+  // The bridge logs each message. We don't need them.
+  m_process.setStandardErrorFile(QProcess::nullDevice());
+
+  m_process.start(m_app, QStringList(),
+                  QProcess::Unbuffered | QProcess::ReadWrite);
+  if (!m_process.waitForStarted()) {
+    return false;
+  }
+
+  // The bridge connects to the VPN client when the first message arrives.
+  // The VPN client answers a message which is not an object with an
+  // "invalidRequest" response.
+  QByteArray warmUp("\"warm up\"");
+  QByteArray reply;
+  if (!writeMessage(warmUp) || !readMessage(reply)) {
+    return false;
+  }
+
+  return m_target == Echo
+             ? reply == warmUp
+             : parseMessage(reply).value("t").toString() == "invalidRequest";
+}
+
+void BridgeBenchmark::stop() {
+  m_process.closeWriteChannel();
+  m_process.terminate();
+
+  if (!m_process.waitForFinished()) {
+    m_process.kill();
+  }
+}
+
+QJsonObject BridgeBenchmark::measure(const QByteArray& message) {
+  QByteArray reply;
+  QElapsedTimer timer;
+
+  // Latency: one message at a time.
+  QVector<qint64> latencies;
+  latencies.reserve(m_iterations);
+
+  for (int i = 0; i < m_iterations; ++i) {
+    timer.start();
+
+    if (!writeMessage(message) || !readMessage(reply)) {
+      qWarning("Round trip failed - size: %d", message.length());
+      return QJsonObject();
+    }
+
+    latencies.append(timer.nsecsElapsed() / 1000);
+
+    if (!checkReply(message, reply)) {
+      qWarning("Unexpected reply - size: %d", message.length());
+      return QJsonObject();
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  // Throughput: many messages in flight. The replies of the VPN client can be
+  // much larger than the requests.
+  int count =
+      qBound(1, PIPELINE_MAX_BYTES / qMax(message.length(), reply.length()),
+             PIPELINE_MAX_MESSAGES);
+
+  timer.start();
+
+  for (int i = 0; i < count; ++i) {
+    if (!writeMessage(message)) {
+      qWarning("Write failed - size: %d", message.length());
+      return QJsonObject();
+    }
+  }
+
+  for (int i = 0; i < count; ++i) {
+    if (!readMessage(reply)) {
+      qWarning("Read failed - size: %d", message.length());
+      return QJsonObject();
+    }
+  }
+
+  double seconds = timer.nsecsElapsed() / 1e9;
+
+  QJsonObject result;
+  if (m_target == Client) {
+    result["request"] = QString::fromUtf8(message);
+    result["replySize"] = reply.length();
+  }
+  result["size"] = message.length();
+  result["p50Usec"] = percentile(latencies, 50);
+  result["p90Usec"] = percentile(latencies, 90);
+  result["p99Usec"] = percentile(latencies, 99);
+  result["maxUsec"] = latencies.last();
+  result["pipelined"] = count;
+  result["messagesPerSec"] = count / seconds;
+  result["bytesPerSec"] = count * reply.length() / seconds;
+  return result;
+}
+
+bool BridgeBenchmark::checkReply(const QByteArray& message,
+                                 const QByteArray& reply) const {
+  if (m_target == Echo) {
+    return reply == message;
+  }
+
+  return parseMessage(reply).value("t") == parseMessage(message).value("t");
+}
+
+bool BridgeBenchmark::writeMessage(const QByteArray& message) {
+  QByteArray frame;
+  frame.resize(sizeof(uint32_t));
+  qToUnaligned<uint32_t>(message.length(), frame.data());
+  frame.append(message);
+
+  return m_process.write(frame) == frame.length();
+}
+
+bool BridgeBenchmark::readMessage(QByteArray& message) {
+  while (true) {
+    int available = m_buffer.length() - m_cursor;
+    if (available >= (int)sizeof(uint32_t)) {
+      uint32_t length =
+          qFromUnaligned<uint32_t>(m_buffer.constData() + m_cursor);
+      if (available - sizeof(uint32_t) >= length) {
+        message = m_buffer.mid(m_cursor + sizeof(uint32_t), length);
+        m_cursor += sizeof(uint32_t) + length;
+        return true;
+      }
+    }
+
+    if (!m_process.waitForReadyRead(WAIT_MSEC)) {
+      return false;
+    }
+
+    m_buffer.remove(0, m_cursor);
+    m_cursor = 0;
+    m_buffer.append(m_process.readAllStandardOutput());
+  }
+}
+
+qint64 BridgeBenchmark::bridgeMaxRssKb() const {
+#ifdef Q_OS_LINUX
+  QFile file(QString("/proc/%1/status").arg(m_process.processId()));
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    return -1;
+  }
+
+  while (!file.atEnd()) {
+    QByteArray line = file.readLine();
+    if (line.startsWith("VmHWM:")) {
+      return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+  }
+#endif
+
+  return -1;
+}
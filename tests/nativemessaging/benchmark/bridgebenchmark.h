@@ -0,0 +1,55 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRIDGEBENCHMARK_H
+#define BRIDGEBENCHMARK_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QProcess>
+
+// Measures the native messaging bridge: round-trip latency percentiles and
+// throughput, and the memory high-water mark of the bridge. The bridge talks
+// either to an echo server which replaces the VPN client, with several
+// message sizes, or to a running VPN client, with its "servers" requests.
+class BridgeBenchmark final {
+ public:
+  enum Target {
+    Echo,
+    Client,
+  };
+
+  BridgeBenchmark(const QString& app, int iterations, Target target);
+  ~BridgeBenchmark();
+
+  // Returns the results, or an empty object if the bridge does not work.
+  QJsonObject run();
+
+ private:
+  bool start();
+  void stop();
+
+  QJsonObject runEcho();
+  QJsonObject runClient();
+
+  QJsonObject measure(const QByteArray& message);
+  bool checkReply(const QByteArray& message, const QByteArray& reply) const;
+
+  bool writeMessage(const QByteArray& message);
+  bool readMessage(QByteArray& message);
+
+  qint64 bridgeMaxRssKb() const;
+
+ private:
+  QString m_app;
+  int m_iterations;
+  Target m_target;
+
+  QProcess m_process;
+
+  QByteArray m_buffer;
+  int m_cursor = 0;
+};
+
+#endif  // BRIDGEBENCHMARK_H
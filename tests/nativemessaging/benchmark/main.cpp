@@ -0,0 +1,63 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "bridgebenchmark.h"
+#include "helperserver.h"
+
+#include <iostream>
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QJsonDocument>
+#include <QStringList>
+
+constexpr int DEFAULT_ITERATIONS = 1000;
+
+int main(int argc, char* argv[]) {
+  QCoreApplication a(argc, argv);
+
+  QStringList args = a.arguments();
+  args.removeFirst();
+
+  // With --client, the bridge talks to the VPN client running on this
+  // machine, instead of the echo server.
+  BridgeBenchmark::Target target = BridgeBenchmark::Echo;
+  if (!args.isEmpty() && args.first() == "--client") {
+    target = BridgeBenchmark::Client;
+    args.removeFirst();
+  }
+
+  if (args.isEmpty()) {
+    std::cout << "Usage: " << argv[0]
+              << " [--client] <nativeMessagingApp> [iterations]" << std::endl;
+    return 1;
+  }
+
+  int iterations = DEFAULT_ITERATIONS;
+  if (args.length() > 1) {
+    iterations = args[1].toInt();
+  }
+
+  HelperServer hs;
+  if (target == BridgeBenchmark::Echo) {
+    QEventLoop loop;
+    QObject::connect(&hs, &HelperServer::ready, [&] { loop.exit(); });
+    hs.start();
+    loop.exec();
+  }
+
+  QJsonObject results = BridgeBenchmark(args[0], iterations, target).run();
+
+  if (target == BridgeBenchmark::Echo) {
+    hs.stop();
+  }
+
+  if (results.isEmpty()) {
+    std::cerr << "Benchmark failed" << std::endl;
+    return 1;
+  }
+
+  std::cout << QJsonDocument(results).toJson().constData();
+  return 0;
+}
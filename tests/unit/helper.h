@@ -23,6 +23,9 @@ class TestHelper : public QObject {
     enum NetworkStatus {
       Success,
       Failure,
+      Unchanged,
+      // The request never completes, unless it is aborted.
+      Pending,
     };
     NetworkStatus m_status;
     QByteArray m_body;
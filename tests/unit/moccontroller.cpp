@@ -39,6 +39,9 @@ int Controller::time() const { return 42; }
 
 void Controller::getBackendLogs(std::function<void(const QString&)>&&) {}
 
+void Controller::getBackendLogsChunk(
+    const QString&, std::function<void(const QString&, const QString&)>&&) {}
+
 void Controller::statusUpdated(const QString&, const QString&, uint64_t,
                                uint64_t) {}
 
@@ -39,8 +39,6 @@ void MozillaVPN::scheduleTask(Task* task) {
   task->run(this);
 }
 
-void MozillaVPN::maybeRunTask() {}
-
 void MozillaVPN::deleteTasks() {}
 
 void MozillaVPN::setToken(const QString&) {}
@@ -96,8 +94,6 @@ void MozillaVPN::viewLogs() {}
 
 bool MozillaVPN::modelsInitialized() const { return true; }
 
-void MozillaVPN::taskCompleted() {}
-
 void MozillaVPN::requestSettings() {}
 
 void MozillaVPN::requestAbout() {}
@@ -16,11 +16,22 @@ NetworkRequest::NetworkRequest(QObject* parent, int status)
   Q_ASSERT(!TestHelper::networkConfig.isEmpty());
   TestHelper::NetworkConfig nc = TestHelper::networkConfig.takeFirst();
 
+  if (nc.m_status == TestHelper::NetworkConfig::Pending) {
+    return;
+  }
+
   TimerSingleShot::create(this, 0, [this, nc]() {
     deleteLater();
 
+    if (m_completed) {
+      return;
+    }
+    m_completed = true;
+
     if (nc.m_status == TestHelper::NetworkConfig::Failure) {
       emit requestFailed(QNetworkReply::NetworkError::HostNotFoundError, "");
+    } else if (nc.m_status == TestHelper::NetworkConfig::Unchanged) {
+      emit requestUnchanged();
     } else {
       Q_ASSERT(nc.m_status == TestHelper::NetworkConfig::Success);
 
@@ -99,4 +110,15 @@ NetworkRequest* NetworkRequest::createForSurveyData(QObject* parent) {
 
 void NetworkRequest::replyFinished() { QFAIL("Not called!"); }
 
+int NetworkRequest::statusCode() const { return 200; }
+
 void NetworkRequest::timeout() {}
+
+void NetworkRequest::abort() {
+  if (m_completed) {
+    return;
+  }
+
+  m_completed = true;
+  emit requestFailed(QNetworkReply::OperationCanceledError, "");
+}
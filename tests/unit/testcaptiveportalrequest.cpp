@@ -0,0 +1,122 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testcaptiveportalrequest.h"
+#include "../../src/captiveportal/captiveportalrequest.h"
+#include "../../src/networkrequest.h"
+#include "../../src/settingsholder.h"
+
+namespace {
+
+// Runs a detection with 2 probes and returns the results emitted.
+QList<CaptivePortalResult> detect(const QString& networkId,
+                                  QList<QNetworkReply::NetworkError>& errors) {
+  CaptivePortalRequest* request = new CaptivePortalRequest(nullptr, networkId);
+
+  QList<CaptivePortalResult> results;
+  QEventLoop loop;
+  QObject::connect(request, &CaptivePortalRequest::completed,
+                   [&](CaptivePortalResult result) {
+                     results.append(result);
+                     loop.exit();
+                   });
+
+  request->run();
+
+  QList<NetworkRequest*> probes = request->findChildren<NetworkRequest*>();
+  Q_ASSERT(probes.length() == 2);
+  for (NetworkRequest* probe : probes) {
+    QObject::connect(
+        probe, &NetworkRequest::requestFailed,
+        [&](QNetworkReply::NetworkError error, const QByteArray&) {
+          errors.append(error);
+        });
+  }
+
+  loop.exec();
+  return results;
+}
+
+}  // namespace
+
+void TestCaptivePortalRequest::noPortal() {
+  SettingsHolder settingsHolder;
+  settingsHolder.setCaptivePortalIpv4Addresses(
+      QStringList{"1.2.3.4", "5.6.7.8"});
+  CaptivePortalRequest::clearCache();
+
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Success, "success"));
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Success, "success"));
+
+  QList<QNetworkReply::NetworkError> errors;
+  QList<CaptivePortalResult> results = detect("network", errors);
+  QCOMPARE(results, QList<CaptivePortalResult>{NoPortal});
+
+  // The losing probe has been aborted.
+  QCOMPARE(errors, QList<QNetworkReply::NetworkError>{
+                       QNetworkReply::OperationCanceledError});
+
+  // No portal is never cached.
+  CaptivePortalResult cached = Failure;
+  QVERIFY(!CaptivePortalRequest::cachedResult("network", &cached));
+}
+
+void TestCaptivePortalRequest::portalDetected() {
+  SettingsHolder settingsHolder;
+  settingsHolder.setCaptivePortalIpv4Addresses(
+      QStringList{"1.2.3.4", "5.6.7.8"});
+  CaptivePortalRequest::clearCache();
+
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Success, "login"));
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Success, "login"));
+
+  QList<QNetworkReply::NetworkError> errors;
+  QList<CaptivePortalResult> results = detect("network", errors);
+  QCOMPARE(results, QList<CaptivePortalResult>{PortalDetected});
+  QCOMPARE(errors.length(), 1);
+
+  CaptivePortalResult cached = Failure;
+  QVERIFY(CaptivePortalRequest::cachedResult("network", &cached));
+  QCOMPARE(cached, PortalDetected);
+  QVERIFY(!CaptivePortalRequest::cachedResult("other", &cached));
+  QVERIFY(!CaptivePortalRequest::cachedResult(QString(), &cached));
+
+  // The portal is gone: the cached result is dropped.
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Success, "success"));
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Success, "success"));
+
+  errors.clear();
+  results = detect("network", errors);
+  QCOMPARE(results, QList<CaptivePortalResult>{NoPortal});
+  QVERIFY(!CaptivePortalRequest::cachedResult("network", &cached));
+}
+
+void TestCaptivePortalRequest::failure() {
+  SettingsHolder settingsHolder;
+  settingsHolder.setCaptivePortalIpv4Addresses(
+      QStringList{"1.2.3.4", "5.6.7.8"});
+  CaptivePortalRequest::clearCache();
+
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Failure, ""));
+  TestHelper::networkConfig.append(
+      TestHelper::NetworkConfig(TestHelper::NetworkConfig::Failure, ""));
+
+  // The result is a failure only when all the probes have failed.
+  QList<QNetworkReply::NetworkError> errors;
+  QList<CaptivePortalResult> results = detect("network", errors);
+  QCOMPARE(results, QList<CaptivePortalResult>{Failure});
+  QCOMPARE(errors.length(), 2);
+
+  CaptivePortalResult cached = Failure;
+  QVERIFY(!CaptivePortalRequest::cachedResult("network", &cached));
+}
+
+static TestCaptivePortalRequest s_testCaptivePortalRequest;
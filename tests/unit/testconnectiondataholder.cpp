@@ -115,4 +115,57 @@ void TestConnectionDataHolder::chart() {
   QCOMPARE(cdh.rxBytes(), (uint32_t)0);
 }
 
+void TestConnectionDataHolder::chartRingBuffer() {
+  ConnectionDataHolder cdh;
+
+  SettingsHolder settingsHolder;
+  settingsHolder.setIpv6Enabled(false);
+
+  TestHelper::networkConfig.append(TestHelper::NetworkConfig(
+      TestHelper::NetworkConfig::Success, QString("{'ip':'42'}").toUtf8()));
+
+  QtCharts::QSplineSeries* txSeries = new QtCharts::QSplineSeries(this);
+  QtCharts::QSplineSeries* rxSeries = new QtCharts::QSplineSeries(this);
+  QtCharts::QValueAxis* axisX = new QtCharts::QValueAxis(this);
+  QtCharts::QValueAxis* axisY = new QtCharts::QValueAxis(this);
+
+  cdh.activate(QVariant::fromValue(txSeries), QVariant::fromValue(rxSeries),
+               QVariant::fromValue(axisX), QVariant::fromValue(axisY));
+
+  // The first call is the baseline. Then, the deltas are 1, 2, 3...
+  uint64_t total = 0;
+  cdh.add(total, total * 2);
+
+  int samples = Constants::CHARTS_MAX_POINTS + 5;
+  for (int i = 1; i <= samples; ++i) {
+    total += i;
+    cdh.add(total, total * 2);
+
+    // Only the last point has a value until the buffer is full.
+    if (i == 1) {
+      QCOMPARE(txSeries->at(0).y(), 0.0);
+      QCOMPARE(txSeries->at(Constants::CHARTS_MAX_POINTS - 1).y(), 1.0);
+    }
+  }
+
+  QCOMPARE(txSeries->count(), Constants::CHARTS_MAX_POINTS);
+  QCOMPARE(rxSeries->count(), Constants::CHARTS_MAX_POINTS);
+
+  // The oldest deltas have been dropped.
+  for (int i = 0; i < Constants::CHARTS_MAX_POINTS; ++i) {
+    double delta = samples - Constants::CHARTS_MAX_POINTS + 1 + i;
+    QCOMPARE(txSeries->at(i).x(), (double)i);
+    QCOMPARE(txSeries->at(i).y(), delta);
+    QCOMPARE(rxSeries->at(i).y(), delta * 2);
+  }
+
+  QCOMPARE(cdh.txBytes(), (uint64_t)samples);
+  QCOMPARE(cdh.rxBytes(), (uint64_t)samples * 2);
+
+  cdh.reset();
+  QCOMPARE(cdh.txBytes(), (uint64_t)0);
+  QCOMPARE(txSeries->count(), Constants::CHARTS_MAX_POINTS);
+  QCOMPARE(txSeries->at(Constants::CHARTS_MAX_POINTS - 1).y(), 0.0);
+}
+
 static TestConnectionDataHolder s_testConnectionDataHolder;
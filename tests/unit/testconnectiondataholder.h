@@ -14,6 +14,7 @@ class TestConnectionDataHolder final : public TestHelper {
   void checkIpAddressSucceess();
 
   void chart();
+  void chartRingBuffer();
 
   void cleanupTestCase() {
     TestHelper::controllerState = Controller::StateInitializing;
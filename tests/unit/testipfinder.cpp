@@ -4,9 +4,12 @@
 
 #include "testipfinder.h"
 #include "../../src/ipfinder.h"
+#include "../../src/networkrequest.h"
 #include "../../src/settingsholder.h"
 #include "helper.h"
 
+#include <QHostInfo>
+
 void TestIpFinder::abort() {
   SettingsHolder settingsHolder;
   settingsHolder.setIpv6Enabled(false);
@@ -68,4 +71,129 @@ void TestIpFinder::ipv4AndIpv6() {
   loop.exec();
 }
 
+namespace {
+
+QHostInfo hostInfo(const QStringList& addresses) {
+  QList<QHostAddress> list;
+  for (const QString& address : addresses) {
+    list.append(QHostAddress(address));
+  }
+
+  QHostInfo info;
+  info.setAddresses(list);
+  return info;
+}
+
+void appendNetworkConfig(TestHelper::NetworkConfig::NetworkStatus status,
+                         const QString& ip = QString()) {
+  TestHelper::networkConfig.append(TestHelper::NetworkConfig(
+      status, QString("{\"ip\":\"%1\", \"country\": \"123\"}")
+                  .arg(ip)
+                  .toUtf8()));
+}
+
+}  // namespace
+
+void TestIpFinder::stagger() {
+  SettingsHolder settingsHolder;
+  settingsHolder.setIpv6Enabled(false);
+
+  IPFinder* ipFinder = new IPFinder(this);
+
+  QString ipv4;
+  QEventLoop loop;
+  connect(ipFinder, &IPFinder::completed,
+          [&](const QString& a_ipv4, const QString&, const QString&) {
+            ipv4 = a_ipv4;
+            loop.exit();
+          });
+
+  // The first address does not answer: the second one is tried after the
+  // stagger and wins.
+  appendNetworkConfig(TestHelper::NetworkConfig::Pending);
+  appendNetworkConfig(TestHelper::NetworkConfig::Success, "43");
+
+  QElapsedTimer timer;
+  timer.start();
+
+  ipFinder->dnsLookupCompleted(hostInfo({"1.2.3.4", "5.6.7.8"}));
+
+  QList<NetworkRequest*> requests = ipFinder->findChildren<NetworkRequest*>();
+  QCOMPARE(requests.length(), 1);
+  QSignalSpy aborted(requests.first(), &NetworkRequest::requestFailed);
+
+  loop.exec();
+
+  QCOMPARE(ipv4, "43");
+  QVERIFY(timer.elapsed() >= 250);
+  QVERIFY(TestHelper::networkConfig.isEmpty());
+
+  // The loser has been aborted.
+  QCOMPARE(aborted.count(), 1);
+  QCOMPARE(aborted.first().first().value<QNetworkReply::NetworkError>(),
+           QNetworkReply::OperationCanceledError);
+}
+
+void TestIpFinder::failedAddress() {
+  SettingsHolder settingsHolder;
+  settingsHolder.setIpv6Enabled(false);
+
+  IPFinder* ipFinder = new IPFinder(this);
+
+  QString ipv4;
+  QEventLoop loop;
+  connect(ipFinder, &IPFinder::completed,
+          [&](const QString& a_ipv4, const QString&, const QString&) {
+            ipv4 = a_ipv4;
+            loop.exit();
+          });
+
+  // The failure of the first address starts the next one without waiting
+  // for the stagger.
+  appendNetworkConfig(TestHelper::NetworkConfig::Failure);
+  appendNetworkConfig(TestHelper::NetworkConfig::Success, "43");
+
+  QElapsedTimer timer;
+  timer.start();
+
+  ipFinder->dnsLookupCompleted(hostInfo({"1.2.3.4", "5.6.7.8", "9.9.9.9"}));
+  loop.exec();
+
+  QCOMPARE(ipv4, "43");
+  QVERIFY(timer.elapsed() < 250);
+  QVERIFY(TestHelper::networkConfig.isEmpty());
+}
+
+void TestIpFinder::gracePeriod() {
+  SettingsHolder settingsHolder;
+  settingsHolder.setIpv6Enabled(true);
+
+  IPFinder* ipFinder = new IPFinder(this);
+
+  QString ipv4;
+  QString ipv6 = "unset";
+  QEventLoop loop;
+  connect(ipFinder, &IPFinder::completed,
+          [&](const QString& a_ipv4, const QString& a_ipv6, const QString&) {
+            ipv4 = a_ipv4;
+            ipv6 = a_ipv6;
+            loop.exit();
+          });
+
+  // IPv4 answers, IPv6 never does: only IPv4 is published after the grace
+  // period.
+  appendNetworkConfig(TestHelper::NetworkConfig::Success, "42");
+  appendNetworkConfig(TestHelper::NetworkConfig::Pending);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  ipFinder->dnsLookupCompleted(hostInfo({"1.2.3.4", "::1"}));
+  loop.exec();
+
+  QCOMPARE(ipv4, "42");
+  QCOMPARE(ipv6, QString());
+  QVERIFY(timer.elapsed() >= 1500);
+}
+
 static TestIpFinder s_testIpFinder;
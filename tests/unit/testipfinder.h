@@ -11,4 +11,7 @@ class TestIpFinder final : public TestHelper {
   void abort();
   void ipv4Only();
   void ipv4AndIpv6();
+  void stagger();
+  void failedAddress();
+  void gracePeriod();
 };
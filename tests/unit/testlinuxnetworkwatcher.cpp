@@ -0,0 +1,57 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testlinuxnetworkwatcher.h"
+#include "../../src/platforms/linux/linuxnetworkwatcherworker.h"
+
+#include <QtDBus/QtDBus>
+
+void TestLinuxNetworkWatcher::accessPointChanges() {
+  LinuxNetworkWatcherWorker worker(QThread::currentThread());
+
+  // An open network is active on the wifi device.
+  worker.m_devicePaths.append("/device/1");
+  worker.m_properties["/device/1"].insert(
+      "ActiveAccessPoint", QVariant::fromValue(QDBusObjectPath("/ap/1")));
+
+  QVariantMap& ap = worker.m_properties["/ap/1"];
+  ap.insert("Ssid", "Hotel");
+  ap.insert("HwAddress", "00:11:22:33:44:55");
+  ap.insert("RsnFlags", 0);
+  ap.insert("WpaFlags", 0);
+
+  QSignalSpy networkChanged(&worker,
+                            &LinuxNetworkWatcherWorker::networkChanged);
+  QSignalSpy unsecuredNetwork(&worker,
+                              &LinuxNetworkWatcherWorker::unsecuredNetwork);
+
+  QDBusMessage message = QDBusMessage::createSignal(
+      "/ap/1", "org.freedesktop.DBus.Properties", "PropertiesChanged");
+
+  // A scan updates the strength only: the cache changes, nothing is emitted.
+  worker.propertyChanged("org.freedesktop.NetworkManager.AccessPoint",
+                         QVariantMap{{"Strength", 80}}, QStringList(),
+                         message);
+  QCOMPARE(worker.m_properties["/ap/1"].value("Strength").toInt(), 80);
+  QCOMPARE(networkChanged.count(), 0);
+  QCOMPARE(unsecuredNetwork.count(), 0);
+
+  // The security flags are checked again.
+  worker.propertyChanged("org.freedesktop.NetworkManager.AccessPoint",
+                         QVariantMap{{"RsnFlags", 0}}, QStringList(),
+                         message);
+  QCOMPARE(networkChanged.count(), 1);
+  QCOMPARE(unsecuredNetwork.count(), 1);
+
+  // Unknown access points are ignored.
+  QDBusMessage otherMessage = QDBusMessage::createSignal(
+      "/ap/2", "org.freedesktop.DBus.Properties", "PropertiesChanged");
+  worker.propertyChanged("org.freedesktop.NetworkManager.AccessPoint",
+                         QVariantMap{{"Ssid", "Other"}}, QStringList(),
+                         otherMessage);
+  QVERIFY(!worker.m_properties.contains("/ap/2"));
+  QCOMPARE(networkChanged.count(), 1);
+}
+
+static TestLinuxNetworkWatcher s_testLinuxNetworkWatcher;
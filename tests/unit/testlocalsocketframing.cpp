@@ -0,0 +1,73 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testlocalsocketframing.h"
+#include "../../src/localsocketframing.h"
+
+void TestLocalSocketFraming::jsonLines() {
+  LocalSocketFraming framing;
+  QVERIFY(!framing.framesEnabled());
+
+  QJsonObject obj;
+  obj.insert("type", "status");
+
+  QByteArray data = framing.serialize(obj);
+  QVERIFY(data.endsWith('\n'));
+
+  // Two messages and an empty line, split in the middle of the second one.
+  framing.append(data + "\n" + data.left(5));
+
+  QJsonObject message;
+  QVERIFY(framing.readMessage(message));
+  QCOMPARE(message.value("type").toString(), "status");
+  QVERIFY(!framing.readMessage(message));
+
+  framing.append(data.mid(5));
+  QVERIFY(framing.readMessage(message));
+  QCOMPARE(message.value("type").toString(), "status");
+  QVERIFY(!framing.readMessage(message));
+
+  // Invalid lines are skipped.
+  framing.append("foo\n" + data);
+  QVERIFY(framing.readMessage(message));
+  QCOMPARE(message.value("type").toString(), "status");
+  QVERIFY(!framing.readMessage(message));
+}
+
+void TestLocalSocketFraming::frames() {
+  LocalSocketFraming framing;
+  framing.enableFrames();
+
+  QJsonObject obj;
+  obj.insert("type", "logs");
+  obj.insert("logs", "Hello\nworld");
+  obj.insert("rxBytes", 42);
+
+  QByteArray frame = framing.serialize(obj);
+  QCOMPARE(frame.at(0), '\0');
+
+  // Frames and JSON lines can be mixed.
+  LocalSocketFraming reader;
+  QByteArray data = frame + "{\"type\":\"status\"}\n" + frame;
+  for (int i = 0; i < data.length(); ++i) {
+    reader.append(data.mid(i, 1));
+  }
+
+  QJsonObject message;
+  QVERIFY(reader.readMessage(message));
+  QCOMPARE(message.value("type").toString(), "logs");
+  QCOMPARE(message.value("logs").toString(), "Hello\nworld");
+  QVERIFY(message.value("rxBytes").isDouble());
+  QCOMPARE(message.value("rxBytes").toDouble(), 42.0);
+
+  QVERIFY(reader.readMessage(message));
+  QCOMPARE(message.value("type").toString(), "status");
+
+  QVERIFY(reader.readMessage(message));
+  QCOMPARE(message, obj);
+
+  QVERIFY(!reader.readMessage(message));
+}
+
+static TestLocalSocketFraming s_testLocalSocketFraming;
@@ -7,6 +7,10 @@
 #include "../../src/loghandler.h"
 #include "helper.h"
 
+#include <QDir>
+#include <QStandardPaths>
+#include <QThreadPool>
+
 void TestLogger::logger() {
   Logger l("test", "class");
   l.log() << "Hello world" << 42 << 'a' << QString("OK") << QByteArray("Array")
@@ -41,4 +45,103 @@ void TestLogger::logHandler() {
   }
 }
 
+void TestLogger::logRotation() {
+  LogHandler* lh = LogHandler::instance();
+  lh->cleanupLogs();
+
+  Logger l("test", "class");
+  l.log() << "First line";
+
+  // Enough data to fill more than one segment.
+  QString line(1024, 'x');
+  for (int i = 0; i < 512; ++i) {
+    l.log() << line;
+  }
+
+  l.log() << "Last line";
+
+  QString buffer;
+  {
+    QTextStream out(&buffer);
+    lh->writeLogs(out);
+  }
+
+  QVERIFY(buffer.contains("First line"));
+  QVERIFY(buffer.contains("Last line"));
+  QVERIFY(buffer.indexOf("First line") < buffer.indexOf("Last line"));
+
+  // Let's go beyond the total cap: the oldest segments are dropped.
+  for (int i = 0; i < 2600; ++i) {
+    l.log() << line;
+  }
+
+  QThreadPool::globalInstance()->waitForDone();
+
+  QDir logDir(
+      QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+  QFileInfoList segments =
+      logDir.entryInfoList(QStringList{"mozillavpn-*"}, QDir::Files);
+  QVERIFY(segments.length() > 1);
+
+  qint64 segmentsSize = 0;
+  qint64 maxSegmentSize = 0;
+  for (const QFileInfo& segment : segments) {
+    segmentsSize += segment.size();
+    maxSegmentSize = qMax(maxSegmentSize, segment.size());
+  }
+
+  // The closed segments share the total cap (LOG_MAX_TOTAL_SIZE) with the
+  // active one (up to LOG_MAX_FILE_SIZE). As many segments as fit are kept:
+  // one more would not fit. The segment sizes differ by less than a line.
+  qint64 available = 2097152 - 204800;
+  QVERIFY(segmentsSize <= available);
+  QVERIFY(segmentsSize + maxSegmentSize + 2048 > available);
+  QCOMPARE(segments.length(), (int)(available / (maxSegmentSize + 2048)));
+
+  qint64 activeSize = QFileInfo(logDir.filePath("mozillavpn.txt")).size();
+  QVERIFY(activeSize < 204800 + 2048);
+  QVERIFY(segmentsSize + activeSize < 2097152 + 2048);
+
+  buffer.clear();
+  {
+    QTextStream out(&buffer);
+    lh->writeLogs(out);
+  }
+  QVERIFY(!buffer.contains("First line"));
+
+  lh->cleanupLogs();
+}
+
+void TestLogger::logChunks() {
+  LogHandler* lh = LogHandler::instance();
+  lh->cleanupLogs();
+
+  Logger l("test", "class");
+  QString line(1024, 'y');
+  for (int i = 0; i < 512; ++i) {
+    l.log() << line;
+  }
+
+  QString buffer;
+  {
+    QTextStream out(&buffer);
+    lh->writeLogs(out);
+  }
+
+  QByteArray chunks;
+  QString cursor;
+  int count = 0;
+  do {
+    QString nextCursor;
+    chunks.append(LogHandler::readLogChunk(cursor, nextCursor));
+    cursor = nextCursor;
+    ++count;
+  } while (!cursor.isEmpty());
+
+  QVERIFY(count > 1);
+  QCOMPARE(QString::fromUtf8(chunks), buffer);
+
+  lh->cleanupLogs();
+}
+
 static TestLogger s_testLogger;
@@ -11,4 +11,8 @@ class TestLogger final : public TestHelper {
   void logger();
 
   void logHandler();
+
+  void logRotation();
+
+  void logChunks();
 };
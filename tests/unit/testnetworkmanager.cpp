@@ -3,9 +3,13 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "testnetworkmanager.h"
+#include "../../src/networkrequeststats.h"
 #include "../../src/simplenetworkmanager.h"
 #include "helper.h"
 
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+
 void TestNetworkManager::basic() {
   SimpleNetworkManager snm;
   QCOMPARE(&snm, NetworkManager::instance());
@@ -13,4 +17,93 @@ void TestNetworkManager::basic() {
   QCOMPARE(snm.networkAccessManager(), snm.networkAccessManager());
 }
 
+void TestNetworkManager::pools() {
+  SimpleNetworkManager snm;
+
+  QNetworkAccessManager* api =
+      snm.networkAccessManager(NetworkManager::ApiPool);
+  QCOMPARE(api, snm.networkAccessManager());
+
+  QNetworkAccessManager* probe =
+      snm.networkAccessManager(NetworkManager::ProbePool);
+  QVERIFY(probe != api);
+  QCOMPARE(snm.networkAccessManager(NetworkManager::ProbePool), probe);
+
+  // A pending probe keeps its manager alive.
+  snm.increaseNetworkRequestCount(NetworkManager::ProbePool);
+  snm.discardProbeNetworkAccessManager();
+  QCOMPARE(snm.networkAccessManager(NetworkManager::ProbePool), probe);
+
+  snm.decreaseNetworkRequestCount(NetworkManager::ProbePool);
+  QVERIFY(snm.networkAccessManager(NetworkManager::ProbePool) != probe);
+  QCOMPARE(snm.networkAccessManager(NetworkManager::ApiPool), api);
+
+  // Stats
+  snm.recordConnection(NetworkManager::ApiPool, true, 40);
+  snm.recordConnection(NetworkManager::ApiPool, true, 20);
+  snm.recordConnection(NetworkManager::ApiPool, false, 0);
+
+  const NetworkManager::PoolStats& stats =
+      snm.poolStats(NetworkManager::ApiPool);
+  QCOMPARE(stats.m_handshakes, (uint32_t)2);
+  QCOMPARE(stats.m_reusedConnections, (uint32_t)1);
+  QCOMPARE(stats.m_handshakeTotalMsec, (uint64_t)60);
+  QCOMPARE(stats.m_handshakeMaxMsec, (uint32_t)40);
+  QCOMPARE(snm.poolStats(NetworkManager::ProbePool).m_handshakes,
+           (uint32_t)0);
+}
+
+void TestNetworkManager::requestStats() {
+  NetworkRequestStats::Histogram histogram;
+  QCOMPARE(histogram.percentile(0.5), (quint64)0);
+
+  for (int i = 1; i <= 100; ++i) {
+    histogram.add(i);
+  }
+
+  QCOMPARE(histogram.count(), (quint64)100);
+  QCOMPARE(histogram.max(), (quint64)100);
+  // 50 is in the bucket [32, 64), 90 and 99 in [64, 128).
+  QCOMPARE(histogram.percentile(0.5), (quint64)63);
+  QCOMPARE(histogram.percentile(0.9), (quint64)100);
+  QCOMPARE(histogram.percentile(0.99), (quint64)100);
+
+  NetworkRequestStats::reset();
+
+  NetworkRequestStats::Sample sample;
+  sample.m_firstByteMsec = 20;
+  sample.m_totalMsec = 30;
+  sample.m_bytesReceived = 1000;
+  NetworkRequestStats::record("servers", sample);
+
+  sample.m_setupMsec = 10;
+  sample.m_failed = true;
+  NetworkRequestStats::record("servers", sample);
+
+  QJsonObject endpoints =
+      NetworkRequestStats::status().value("endpoints").toObject();
+  QJsonObject servers = endpoints.value("servers").toObject();
+  QCOMPARE(servers["requests"].toInt(), 2);
+  QCOMPARE(servers["failures"].toInt(), 1);
+  QCOMPARE(servers["setupMsec"].toObject()["count"].toInt(), 1);
+  QCOMPARE(servers["totalMsec"].toObject()["count"].toInt(), 2);
+  QCOMPARE(servers["bytesReceived"].toObject()["max"].toInt(), 1000);
+
+  QVERIFY(NetworkRequestStats::report().contains("servers"));
+
+  // A retried attempt is not a failure.
+  sample.m_retried = true;
+  NetworkRequestStats::record("servers", sample);
+
+  endpoints = NetworkRequestStats::status().value("endpoints").toObject();
+  servers = endpoints.value("servers").toObject();
+  QCOMPARE(servers["requests"].toInt(), 3);
+  QCOMPARE(servers["failures"].toInt(), 1);
+  QCOMPARE(servers["retries"].toInt(), 1);
+
+  NetworkRequestStats::reset();
+  endpoints = NetworkRequestStats::status().value("endpoints").toObject();
+  QVERIFY(endpoints.isEmpty());
+}
+
 static TestNetworkManager s_testNetworkManager;
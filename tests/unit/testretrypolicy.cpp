@@ -0,0 +1,63 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testretrypolicy.h"
+#include "../../src/retrypolicy.h"
+
+void TestRetryPolicy::backoff() {
+  RetryPolicy none;
+  QVERIFY(!none.enabled());
+  QVERIFY(!none.canRetry(1));
+
+  RetryPolicy policy(4, 1000, 3000);
+  QVERIFY(policy.enabled());
+  QVERIFY(policy.canRetry(3));
+  QVERIFY(!policy.canRetry(4));
+
+  for (int i = 0; i < 100; ++i) {
+    uint32_t first = policy.delayMsec(1);
+    QVERIFY(first >= 500 && first <= 1000);
+
+    uint32_t second = policy.delayMsec(2);
+    QVERIFY(second >= 1000 && second <= 2000);
+
+    // Capped
+    uint32_t third = policy.delayMsec(3);
+    QVERIFY(third >= 1500 && third <= 3000);
+  }
+}
+
+void TestRetryPolicy::retryable() {
+  QVERIFY(RetryPolicy::isRetryable(QNetworkReply::HostNotFoundError, 0));
+  QVERIFY(RetryPolicy::isRetryable(QNetworkReply::TimeoutError, 0));
+  QVERIFY(
+      RetryPolicy::isRetryable(QNetworkReply::ServiceUnavailableError, 503));
+  QVERIFY(RetryPolicy::isRetryable(QNetworkReply::UnknownContentError, 429));
+
+  QVERIFY(!RetryPolicy::isRetryable(QNetworkReply::OperationCanceledError, 0));
+  QVERIFY(!RetryPolicy::isRetryable(
+      QNetworkReply::AuthenticationRequiredError, 401));
+  QVERIFY(!RetryPolicy::isRetryable(QNetworkReply::ContentNotFoundError, 404));
+}
+
+void TestRetryPolicy::budget() {
+  RetryPolicy::resetBudget();
+
+  int retries = 0;
+  while (RetryPolicy::consumeBudget()) {
+    ++retries;
+  }
+  QCOMPARE(retries, 10);
+
+  // Five new requests earn one retry.
+  for (int i = 0; i < 5; ++i) {
+    RetryPolicy::requestStarted();
+  }
+  QVERIFY(RetryPolicy::consumeBudget());
+  QVERIFY(!RetryPolicy::consumeBudget());
+
+  RetryPolicy::resetBudget();
+}
+
+static TestRetryPolicy s_testRetryPolicy;
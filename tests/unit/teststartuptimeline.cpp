@@ -0,0 +1,74 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "teststartuptimeline.h"
+#include "../../src/startuptimeline.h"
+
+#include <QJsonArray>
+
+void TestStartupTimeline::notStarted() {
+  StartupTimeline::reset();
+  QVERIFY(!StartupTimeline::isStarted());
+  QCOMPARE(StartupTimeline::nowNsec(), (qint64)-1);
+
+  {
+    StartupTimeline::Span span("ignored");
+  }
+  StartupTimeline::mark("ignored");
+  StartupTimeline::record("ignored", 0);
+
+  QVERIFY(StartupTimeline::toChromeTrace()["traceEvents"].toArray().isEmpty());
+}
+
+void TestStartupTimeline::spans() {
+  StartupTimeline::reset();
+  StartupTimeline::start();
+  QVERIFY(StartupTimeline::isStarted());
+
+  qint64 start = StartupTimeline::nowNsec();
+  QVERIFY(start >= 0);
+
+  {
+    StartupTimeline::Span outer("outer");
+    {
+      StartupTimeline::Span inner("inner");
+      StartupTimeline::mark("mark");
+    }
+  }
+
+  StartupTimeline::record("record", start);
+
+  QJsonObject trace = StartupTimeline::toChromeTrace();
+  QCOMPARE(trace["displayTimeUnit"].toString(), "ms");
+
+  QJsonArray events = trace["traceEvents"].toArray();
+  QCOMPARE(events.count(), 4);
+
+  // The spans are recorded when they end.
+  QJsonObject mark = events.at(0).toObject();
+  QCOMPARE(mark["name"].toString(), "mark");
+  QCOMPARE(mark["ph"].toString(), "i");
+  QCOMPARE(mark["args"].toObject()["depth"].toInt(), 2);
+
+  QJsonObject inner = events.at(1).toObject();
+  QCOMPARE(inner["name"].toString(), "inner");
+  QCOMPARE(inner["ph"].toString(), "X");
+  QCOMPARE(inner["args"].toObject()["depth"].toInt(), 1);
+
+  QJsonObject outer = events.at(2).toObject();
+  QCOMPARE(outer["name"].toString(), "outer");
+  QCOMPARE(outer["args"].toObject()["depth"].toInt(), 0);
+  QVERIFY(outer["ts"].toDouble() <= inner["ts"].toDouble());
+  QVERIFY(outer["ts"].toDouble() + outer["dur"].toDouble() >=
+          inner["ts"].toDouble() + inner["dur"].toDouble());
+  QCOMPARE(outer["tid"].toDouble(), inner["tid"].toDouble());
+
+  QJsonObject record = events.at(3).toObject();
+  QCOMPARE(record["name"].toString(), "record");
+  QVERIFY(record["dur"].toDouble() >= outer["dur"].toDouble());
+
+  StartupTimeline::reset();
+}
+
+static TestStartupTimeline s_testStartupTimeline;
@@ -7,6 +7,24 @@
 #include "../../src/tasks/accountandservers/taskaccountandservers.h"
 #include "../../src/tasks/adddevice/taskadddevice.h"
 #include "../../src/tasks/function/taskfunction.h"
+#include "../../src/taskscheduler.h"
+
+namespace {
+// A task completed by the test itself.
+class ManualTask final : public Task {
+ public:
+  ManualTask(const QString& name, uint32_t groups,
+             const QString& key = QString())
+      : Task(name, groups), m_key(key) {}
+
+  void run(MozillaVPN*) override { m_running = true; }
+
+  QString coalescingKey() const override { return m_key; }
+
+  QString m_key;
+  bool m_running = false;
+};
+}  // namespace
 
 void TestTasks::accountAndServers() {
   // Failure
@@ -40,6 +58,22 @@ void TestTasks::accountAndServers() {
     MozillaVPN::instance()->scheduleTask(task);
     loop.exec();
   }
+
+  // Unchanged
+  {
+    TestHelper::networkConfig.append(TestHelper::NetworkConfig(
+        TestHelper::NetworkConfig::Unchanged, QByteArray()));
+    TestHelper::networkConfig.append(TestHelper::NetworkConfig(
+        TestHelper::NetworkConfig::Unchanged, QByteArray()));
+
+    TaskAccountAndServers* task = new TaskAccountAndServers();
+
+    QEventLoop loop;
+    connect(task, &Task::completed, [&]() { loop.exit(); });
+
+    MozillaVPN::instance()->scheduleTask(task);
+    loop.exec();
+  }
 }
 
 void TestTasks::addDevice_success() {
@@ -87,4 +121,91 @@ void TestTasks::removeDevice() {
   // TODO
 }
 
+void TestTasks::scheduler() {
+  TaskScheduler scheduler;
+
+  ManualTask* a = new ManualTask("A", Task::GroupAccount);
+  ManualTask* b = new ManualTask("B", Task::GroupSurvey);
+  ManualTask* c = new ManualTask("C", Task::GroupAccount);
+  ManualTask* d = new ManualTask("D", Task::GroupController);
+
+  scheduler.scheduleTask(a);
+  scheduler.scheduleTask(b);
+  scheduler.scheduleTask(c);
+  scheduler.scheduleTask(d);
+
+  // C waits for A. The others run concurrently.
+  QVERIFY(a->m_running);
+  QVERIFY(b->m_running);
+  QVERIFY(!c->m_running);
+  QVERIFY(d->m_running);
+  QCOMPARE(scheduler.pendingTasks(), 1);
+  QCOMPARE(scheduler.runningTasks(), 3);
+
+  emit a->completed();
+  QVERIFY(c->m_running);
+  QCOMPARE(scheduler.pendingTasks(), 0);
+
+  // A task in GroupAll waits for all the previous tasks and blocks the
+  // following ones.
+  ManualTask* e = new ManualTask("E", Task::GroupAll);
+  ManualTask* f = new ManualTask("F", Task::GroupSurvey);
+  scheduler.scheduleTask(e);
+  scheduler.scheduleTask(f);
+  QVERIFY(!e->m_running);
+  QVERIFY(!f->m_running);
+
+  emit b->completed();
+  emit c->completed();
+  emit d->completed();
+  QVERIFY(e->m_running);
+  QVERIFY(!f->m_running);
+
+  emit e->completed();
+  QVERIFY(f->m_running);
+
+  scheduler.deleteTasks();
+  QCOMPARE(scheduler.pendingTasks(), 0);
+  QCOMPARE(scheduler.runningTasks(), 0);
+}
+
+void TestTasks::coalescing() {
+  TaskScheduler scheduler;
+
+  ManualTask* a = new ManualTask("A", Task::GroupAccount, "account");
+  ManualTask* b = new ManualTask("B", Task::GroupAccount, "account");
+  ManualTask* c = new ManualTask("C", Task::GroupAccount, "account");
+  ManualTask* d = new ManualTask("D", Task::GroupAccount);
+  ManualTask* e = new ManualTask("E", Task::GroupAccount);
+
+  // A is running: B waits.
+  scheduler.scheduleTask(a);
+  scheduler.scheduleTask(b);
+  QCOMPARE(scheduler.pendingTasks(), 1);
+
+  // C is dropped because B is pending.
+  scheduler.scheduleTask(c);
+  QCOMPARE(scheduler.pendingTasks(), 1);
+
+  // No key, no coalescing.
+  scheduler.scheduleTask(d);
+  scheduler.scheduleTask(e);
+  QCOMPARE(scheduler.pendingTasks(), 3);
+
+  // D and E are scheduled after B: F must run after them.
+  ManualTask* f = new ManualTask("F", Task::GroupAccount, "account");
+  scheduler.scheduleTask(f);
+  QCOMPARE(scheduler.pendingTasks(), 4);
+
+  // F is the last pending task of the group.
+  ManualTask* g = new ManualTask("G", Task::GroupAccount, "account");
+  scheduler.scheduleTask(g);
+  QCOMPARE(scheduler.pendingTasks(), 4);
+
+  emit a->completed();
+  QVERIFY(b->m_running);
+
+  scheduler.deleteTasks();
+}
+
 static TestTasks s_testTasks;
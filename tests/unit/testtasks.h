@@ -18,4 +18,7 @@ class TestTasks final : public TestHelper {
   void function();
 
   void removeDevice();
+
+  void scheduler();
+  void coalescing();
 };
@@ -0,0 +1,119 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testthroughputhistory.h"
+#include "../../src/throughputhistory.h"
+
+// A round hour, so that the buckets are easy to compute.
+constexpr qint64 START = 1600000000 - (1600000000 % 3600);
+
+void TestThroughputHistory::tiers() {
+  ThroughputHistory th;
+
+  // 2 hours, one sample per second.
+  for (qint64 i = 0; i < 7200; ++i) {
+    th.addSample(START + i, 1, 2);
+  }
+
+  // Only the last 10 minutes are kept per second.
+  QList<ThroughputHistory::Sample> seconds =
+      th.query(START, START + 7200, ThroughputHistory::Seconds);
+  QCOMPARE(seconds.length(), 600);
+  QCOMPARE(seconds.first().m_time, START + 6600);
+  QCOMPARE(seconds.last().m_time, START + 7199);
+  QCOMPARE(seconds.last().m_txBytes, (quint64)1);
+  QCOMPARE(seconds.last().m_rxBytes, (quint64)2);
+
+  QList<ThroughputHistory::Sample> minutes =
+      th.query(START, START + 7200, ThroughputHistory::Minutes);
+  QCOMPARE(minutes.length(), 120);
+  QCOMPARE(minutes.first().m_time, START);
+  QCOMPARE(minutes.first().m_txBytes, (quint64)60);
+  QCOMPARE(minutes.first().m_rxBytes, (quint64)120);
+
+  QList<ThroughputHistory::Sample> hours =
+      th.query(START, START + 7200, ThroughputHistory::Hours);
+  QCOMPARE(hours.length(), 2);
+  QCOMPARE(hours.at(1).m_time, START + 3600);
+  QCOMPARE(hours.at(1).m_txBytes, (quint64)3600);
+
+  // A sample older than the last bucket goes into the last bucket.
+  th.addSample(START, 10, 10);
+  hours = th.query(START, START + 7200, ThroughputHistory::Hours);
+  QCOMPARE(hours.length(), 2);
+  QCOMPARE(hours.at(1).m_txBytes, (quint64)3610);
+}
+
+void TestThroughputHistory::query() {
+  ThroughputHistory th;
+  for (qint64 i = 0; i < 10; ++i) {
+    th.addSample(START + i * 60, 1, 1);
+  }
+
+  // A bucket partially in the range is included.
+  QList<ThroughputHistory::Sample> list =
+      th.query(START + 90, START + 240, ThroughputHistory::Minutes);
+  QCOMPARE(list.length(), 4);
+  QCOMPARE(list.first().m_time, START + 60);
+  QCOMPARE(list.last().m_time, START + 240);
+
+  QVERIFY(th.query(START + 3600, START + 7200, ThroughputHistory::Minutes)
+              .isEmpty());
+
+  QCOMPARE(th.resolutionFor(START, START + 60), ThroughputHistory::Seconds);
+  QCOMPARE(th.resolutionFor(START, START + 3600), ThroughputHistory::Minutes);
+  QCOMPARE(th.resolutionFor(START, START + 86400 * 7),
+           ThroughputHistory::Hours);
+}
+
+void TestThroughputHistory::minuteClosed() {
+  ThroughputHistory th;
+
+  // The first bucket does not close anything.
+  QVERIFY(!th.addSample(START, 1, 1));
+  QVERIFY(!th.addSample(START + 30, 1, 1));
+  QVERIFY(!th.addSample(START + 59, 1, 1));
+
+  QVERIFY(th.addSample(START + 60, 1, 1));
+  QVERIFY(!th.addSample(START + 61, 1, 1));
+
+  // The clock going backward does not close the current minute.
+  QVERIFY(!th.addSample(START, 1, 1));
+
+  QVERIFY(th.addSample(START + 300, 1, 1));
+}
+
+void TestThroughputHistory::serialize() {
+  ThroughputHistory th;
+  for (qint64 i = 0; i < 4000; i += 7) {
+    th.addSample(START + i, i, i * 2);
+  }
+
+  QByteArray data = th.serialize();
+
+  ThroughputHistory copy;
+  QVERIFY(copy.deserialize(data));
+  QCOMPARE(copy.serialize(), data);
+
+  for (int resolution = ThroughputHistory::Seconds;
+       resolution <= ThroughputHistory::Hours; ++resolution) {
+    QList<ThroughputHistory::Sample> a = th.query(
+        START, START + 4000, (ThroughputHistory::Resolution)resolution);
+    QList<ThroughputHistory::Sample> b = copy.query(
+        START, START + 4000, (ThroughputHistory::Resolution)resolution);
+    QCOMPARE(a.length(), b.length());
+    for (int i = 0; i < a.length(); ++i) {
+      QCOMPARE(a.at(i).m_time, b.at(i).m_time);
+      QCOMPARE(a.at(i).m_txBytes, b.at(i).m_txBytes);
+      QCOMPARE(a.at(i).m_rxBytes, b.at(i).m_rxBytes);
+    }
+  }
+
+  // Invalid or truncated data does not change the history.
+  QVERIFY(!copy.deserialize(QByteArray("foo")));
+  QVERIFY(!copy.deserialize(data.left(data.length() - 4)));
+  QCOMPARE(copy.serialize(), data);
+}
+
+static TestThroughputHistory s_testThroughputHistory;
@@ -26,6 +26,7 @@ INCLUDEPATH += \
 
 HEADERS += \
     ../../src/captiveportal/captiveportal.h \
+    ../../src/captiveportal/captiveportalrequest.h \
     ../../src/command.h \
     ../../src/commandlineparser.h \
     ../../src/connectioncheck.h \
@@ -40,6 +41,7 @@ HEADERS += \
     ../../src/leakdetector.h \
     ../../src/localizer.h \
     ../../src/logger.h \
+    ../../src/localsocketframing.h \
     ../../src/loghandler.h \
     ../../src/models/device.h \
     ../../src/models/devicemodel.h \
@@ -56,6 +58,7 @@ HEADERS += \
     ../../src/mozillavpn.h \
     ../../src/networkmanager.h \
     ../../src/networkrequest.h \
+    ../../src/networkrequeststats.h \
     ../../src/networkwatcher.h \
     ../../src/networkwatcherimpl.h \
     ../../src/pinghelper.h \
@@ -67,36 +70,46 @@ HEADERS += \
     ../../src/platforms/dummy/dummypingsendworker.h \
     ../../src/qmlengineholder.h \
     ../../src/releasemonitor.h \
+    ../../src/retrypolicy.h \
     ../../src/serveri18n.h \
     ../../src/settingsholder.h \
     ../../src/simplenetworkmanager.h \
+    ../../src/startuptimeline.h \
     ../../src/statusicon.h \
     ../../src/systemtrayhandler.h \
     ../../src/task.h \
     ../../src/tasks/accountandservers/taskaccountandservers.h \
     ../../src/tasks/adddevice/taskadddevice.h \
     ../../src/tasks/function/taskfunction.h \
+    ../../src/taskscheduler.h \
+    ../../src/throughputhistory.h \
     ../../src/timersingleshot.h \
     ../../src/update/updater.h \
     ../../src/update/versionapi.h \
     ../../src/urlopener.h \
     helper.h \
     testandroidmigration.h \
+    testcaptiveportalrequest.h \
     testcommandlineparser.h \
     testconnectiondataholder.h \
     testlocalizer.h \
+    testlocalsocketframing.h \
     testlogger.h \
     testipaddress.h \
     testipfinder.h \
     testmodels.h \
     testnetworkmanager.h \
     testreleasemonitor.h \
+    testretrypolicy.h \
+    teststartuptimeline.h \
     teststatusicon.h \
     testtasks.h \
+    testthroughputhistory.h \
     testtimersingleshot.h
 
 SOURCES += \
     ../../src/captiveportal/captiveportal.cpp \
+    ../../src/captiveportal/captiveportalrequest.cpp \
     ../../src/command.cpp \
     ../../src/commandlineparser.cpp \
     ../../src/connectioncheck.cpp \
@@ -114,6 +127,7 @@ SOURCES += \
     ../../src/leakdetector.cpp \
     ../../src/localizer.cpp \
     ../../src/logger.cpp \
+    ../../src/localsocketframing.cpp \
     ../../src/loghandler.cpp \
     ../../src/models/device.cpp \
     ../../src/models/devicemodel.cpp \
@@ -128,6 +142,7 @@ SOURCES += \
     ../../src/models/surveymodel.cpp \
     ../../src/models/user.cpp \
     ../../src/networkmanager.cpp \
+    ../../src/networkrequeststats.cpp \
     ../../src/networkwatcher.cpp \
     ../../src/pinghelper.cpp \
     ../../src/pingsender.cpp \
@@ -137,14 +152,18 @@ SOURCES += \
     ../../src/platforms/dummy/dummypingsendworker.cpp \
     ../../src/qmlengineholder.cpp \
     ../../src/releasemonitor.cpp \
+    ../../src/retrypolicy.cpp \
     ../../src/serveri18n.cpp \
     ../../src/settingsholder.cpp \
     ../../src/simplenetworkmanager.cpp \
+    ../../src/startuptimeline.cpp \
     ../../src/statusicon.cpp \
     ../../src/systemtrayhandler.cpp \
     ../../src/tasks/accountandservers/taskaccountandservers.cpp \
     ../../src/tasks/adddevice/taskadddevice.cpp \
     ../../src/tasks/function/taskfunction.cpp \
+    ../../src/taskscheduler.cpp \
+    ../../src/throughputhistory.cpp \
     ../../src/timersingleshot.cpp \
     ../../src/update/updater.cpp \
     ../../src/update/versionapi.cpp \
@@ -154,22 +173,37 @@ SOURCES += \
     mocmozillavpn.cpp \
     mocnetworkrequest.cpp \
     testandroidmigration.cpp \
+    testcaptiveportalrequest.cpp \
     testcommandlineparser.cpp \
     testconnectiondataholder.cpp \
     testlocalizer.cpp \
+    testlocalsocketframing.cpp \
     testlogger.cpp \
     testipaddress.cpp \
     testipfinder.cpp \
     testmodels.cpp \
     testnetworkmanager.cpp \
     testreleasemonitor.cpp \
+    testretrypolicy.cpp \
+    teststartuptimeline.cpp \
     teststatusicon.cpp \
     testtasks.cpp \
+    testthroughputhistory.cpp \
     testtimersingleshot.cpp
 
 # Platform-specific: Linux
 linux {
     # QMAKE_CXXFLAGS *= -Werror
+
+    QT += dbus
+
+    HEADERS += \
+            ../../src/platforms/linux/linuxnetworkwatcherworker.h \
+            testlinuxnetworkwatcher.h
+
+    SOURCES += \
+            ../../src/platforms/linux/linuxnetworkwatcherworker.cpp \
+            testlinuxnetworkwatcher.cpp
 }
 
 # Platform-specific: MacOS